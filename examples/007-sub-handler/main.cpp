@@ -3,6 +3,7 @@
 
 #include <jsonrpc/module.hpp>
 #include <jsonrpc/procedure.hpp>
+#include <jsonrpc/util/describe.hpp>
 
 namespace ts7 {
   namespace jsonrpc_examples {
@@ -102,51 +103,7 @@ namespace ts7 {
   }
 }
 
-namespace ts7 {
-  namespace jsonrpc {
-    namespace util {
-      template<>
-      struct AsJson<ts7::jsonrpc_examples::sub_handler::Math::result_t> {
-        using result_t = ts7::jsonrpc_examples::sub_handler::Math::result_t;
-
-        static constexpr const JsonType type = JsonType::OBJECT;
-
-        static inline constexpr bool IsType(JsonType t) {
-          return type == t;
-        }
-
-        /**
-         * @brief constructor
-         *
-         * Stores the provided integer value for later conversion.
-         *
-         * @param n The integer value that shall be converted.
-         */
-        inline explicit AsJson(const result_t& value)
-          : value(value)
-        {}
-
-        /**
-         * @brief Json value cast
-         *
-         * Casts the instance to a json value. In this case to a number with the !value stored in \ref value.
-         */
-        operator boost::json::value() const {
-          boost::json::object o;
-          o["sum"] = value.sum;
-          o["difference"] = value.difference;
-          o["product"] = value.product;
-          o["division"] = value.division;
-
-          return o;
-        }
-
-        /// THe stored value
-        result_t value;
-      };
-    }
-  }
-}
+TS7_JSONRPC_DESCRIBE(ts7::jsonrpc_examples::sub_handler::Math::result_t, sum, difference, product, division)
 
 int main()
 {
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <boost/asio.hpp>
+#include <boost/json.hpp>
+
+#include "call.hpp"
+#include "request.hpp"
+#include "util/awaitable.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    /**
+     * @brief Asynchronous call
+     *
+     * Call that completes through an asio completion token instead of a
+     * blocking thread. An outstanding call only costs an entry in the
+     * \ref CallLog. Any completion token works, e.g. a callback,
+     * boost::asio::use_future or boost::asio::use_awaitable.
+     *
+     * @code
+     * AsyncCall<RequestID<std::int32_t>, std::int32_t, std::int32_t, std::int32_t> sum(ctx.get_executor(), "sum", send, "a", "b");
+     * sum(3, 7, [](error::maybe_failed<std::int32_t, error::ErrorCode> result) { ... });
+     * @endcode
+     *
+     * @note The completion signature is void(maybe_failed<TRet, ErrorCode>).
+     * The handler is executed on its associated executor, which defaults to
+     * the executor provided on construction, usually the one of the
+     * transport. Responses need to be handed to \ref CallLog::Release.
+     * With a timeout the call completes with \ref error::CallTimeout, if no
+     * response arrives in time.
+     *
+     * @tparam TId Request id generator, e.g. \ref RequestID.
+     * @tparam TRet Data type of the result.
+     * @tparam TArgs Data types of the parameters.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TId, typename TRet, typename... TArgs>
+    class AsyncCall {
+      public:
+        using request_t = Request<TId, TArgs...>;
+        using request_action_t = std::function<void(const boost::json::object&)>;
+        using executor_t = boost::asio::any_io_executor;
+        using log_t = CallLog<typename TId::type>;
+
+        /// Result of the call
+        using result_t = typename CallResult<TRet>::maybe_failed;
+
+        /// Completion signature
+        using signature_t = void(result_t);
+
+        /**
+         * @brief constructor
+         *
+         * @param executor Default executor of the completion handlers.
+         * @param method Name of the called method.
+         * @param request_action Sends the generated request.
+         * @param args Names of the parameters.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        template <typename... UArgs>
+        AsyncCall(executor_t executor, const std::string& method, request_action_t request_action, UArgs... args)
+          : executor(std::move(executor)),
+            request(method, args...),
+            request_action(request_action)
+        {}
+
+        /**
+         * @brief Call
+         *
+         * Registers the call, sends the request and returns immediately.
+         *
+         * @param args The parameter values.
+         * @param token The completion token.
+         *
+         * @return Returns whatever the completion token defines, e.g. nothing
+         * for callbacks or a future for boost::asio::use_future.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        template <typename CompletionToken>
+        auto operator()(TArgs... args, CompletionToken&& token) {
+          return boost::asio::async_initiate<CompletionToken, signature_t>(
+            [this](auto handler, TArgs... args) {
+              initiate(std::move(handler), args...);
+            },
+            token,
+            args...
+          );
+        }
+
+#ifdef TS7_JSONRPC_HAS_COROUTINES
+        /**
+         * @brief Awaitable call
+         *
+         * Allows to await the result of the call in a C++20 coroutine. The
+         * coroutine is resumed on the executor of the call.
+         *
+         * @note Coroutines of type boost::asio::awaitable only accept asio
+         * operations, use the completion token boost::asio::use_awaitable there.
+         *
+         * @code
+         * error::maybe_failed<std::int32_t, error::ErrorCode> result = co_await sum(3, 7);
+         * @endcode
+         *
+         * @param args The parameter values.
+         *
+         * @return Returns the awaitable of the result.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        auto operator()(TArgs... args) {
+          return util::MakeAwaitable<result_t>([this, args...](auto complete) {
+            (*this)(args..., std::move(complete));
+          });
+        }
+#endif
+
+        inline const executor_t& getExecutor() const {
+          return executor;
+        }
+
+        /// Sets the deadline of the calls, zero disables it
+        inline void setTimeout(typename log_t::timeout_t t) {
+          timeout = t;
+        }
+
+      protected:
+        template <typename THandler>
+        void initiate(THandler handler, TArgs... args) {
+          using handler_t = typename std::decay<THandler>::type;
+
+          // Keeps the executor busy until the handler got executed
+          auto work = boost::asio::prefer(
+            boost::asio::get_associated_executor(handler, executor),
+            boost::asio::execution::outstanding_work.tracked
+          );
+
+          // std::function requires copyable targets, handlers may be move-only
+          std::shared_ptr<handler_t> shared = std::make_shared<handler_t>(std::move(handler));
+
+          boost::json::object requestObject = request(args...);
+          util::FromJson<typename TId::type> id_conv;
+          typename TId::type id = id_conv(requestObject.at("id")).getSuccess();
+
+          // Completes the handler without a response
+          auto fail = [shared, work](const error::ErrorCode& ec) {
+            boost::asio::post(work, [shared, ec]() mutable {
+              std::move(*shared)(result_t(ec));
+            });
+          };
+
+          const bool registered = log_t::Register(id, [shared, work](const boost::json::object& response) {
+            result_t result = CallResult<TRet>::From(response);
+            boost::asio::post(work, [shared, result]() mutable {
+              std::move(*shared)(std::move(result));
+            });
+          }, timeout);
+
+          if ( !registered ) {
+            // The pending call with this id stays registered
+            fail(error::CallIdPending());
+            return;
+          }
+
+          if ( !request_action ) {
+            log_t::Unregister(id);
+            fail(error::NotYetImplemented());
+            return;
+          }
+
+          try {
+            request_action(requestObject);
+          }
+          catch (const std::exception& e) {
+            // A response or the timeout may have completed the call already
+            if ( log_t::Unregister(id) ) {
+              fail(error::InternalError("reason", std::string(e.what())));
+            }
+          }
+        }
+
+        executor_t executor;
+        request_t request;
+        request_action_t request_action;
+        typename log_t::timeout_t timeout = log_t::timeout_t::zero();
+    };
+  }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <boost/asio.hpp>
+#include <boost/json.hpp>
+
+namespace ts7 {
+  namespace jsonrpc {
+    /**
+     * @brief Batch limits
+     *
+     * Limits of a single batch of the \ref Batcher.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    struct BatchLimits {
+        /// Maximum time a message waits for further messages
+        std::chrono::microseconds window = std::chrono::microseconds(200);
+
+        /// Maximum amount of messages in one batch
+        std::size_t max_messages = 64;
+
+        /// Maximum size of one batch in bytes
+        std::size_t max_bytes = 64 * 1024;
+    };
+
+    /**
+     * @brief Batcher
+     *
+     * Collects requests and notifications, that are issued within a short
+     * window, and sends them as one JSON-RPC batch with a single write. It
+     * can be used as request action of \ref Call, \ref AsyncCall and
+     * \ref Notify.
+     *
+     * Every message is serialized once, when it is added. The batch is sent
+     * when the window of its first message elapsed or when the message or
+     * byte limit is reached. A batch with a single message is sent as plain
+     * message.
+     *
+     * The responses of a batch arrive as array. The connection hands every
+     * element to the owner, which releases the waiting call by its id
+     * through the \ref CallLog.
+     *
+     * @code
+     * std::shared_ptr<Batcher> batcher = Batcher::Create(ctx.get_executor(), [conn](const std::string& s) { conn->write(s); });
+     * AsyncCall<RequestID<std::int32_t>, std::int32_t, std::int32_t> call(ctx.get_executor(), "get", std::ref(*batcher), "index");
+     * @endcode
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    class Batcher : public std::enable_shared_from_this<Batcher> {
+      public:
+        using Ptr = std::shared_ptr<Batcher>;
+
+        /// Sends the serialized batch
+        using send_action_t = std::function<void(const std::string&)>;
+
+        using Limits = BatchLimits;
+
+        /**
+         * @brief Create
+         *
+         * Creates a batcher, that uses \p executor for its window timer.
+         *
+         * @param executor Executor of the window timer.
+         * @param send Sends a complete batch.
+         * @param limits Limits of a single batch.
+         *
+         * @return Returns a shared pointer to the created batcher.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline static Ptr Create(boost::asio::any_io_executor executor, send_action_t send, Limits limits = Limits()) {
+          return Ptr(new Batcher(std::move(executor), std::move(send), limits));
+        }
+
+        /**
+         * @brief Add message
+         *
+         * Adds a request or notification to the current batch. This function
+         * is thread safe.
+         *
+         * @param message The message that shall be sent.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        void operator()(const boost::json::object& message) {
+          const std::string serialized = boost::json::serialize(message);
+
+          std::string batch;
+          bool arm = false;
+          {
+            std::lock_guard<std::mutex> lock(m);
+            if (0 == count) {
+              pending.reserve(limits.max_bytes);
+              pending = "[";
+            }
+            else {
+              pending += ',';
+            }
+
+            pending += serialized;
+            ++count;
+
+            if (count >= limits.max_messages || pending.size() >= limits.max_bytes) {
+              batch = take();
+            }
+            else if (!armed) {
+              armed = true;
+              arm = true;
+            }
+          }
+
+          if (!batch.empty()) {
+            send(batch);
+          }
+          else if (arm) {
+            startWindow();
+          }
+        }
+
+        /**
+         * @brief Flush
+         *
+         * Sends the current batch immediately.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        void flush() {
+          std::string batch;
+          {
+            std::lock_guard<std::mutex> lock(m);
+            batch = take();
+          }
+
+          if (!batch.empty()) {
+            send(batch);
+          }
+        }
+
+        inline const Limits& getLimits() const {
+          return limits;
+        }
+
+      protected:
+        inline Batcher(boost::asio::any_io_executor executor, send_action_t send, Limits limits)
+          : strand(boost::asio::make_strand(executor)),
+            timer(strand),
+            send(std::move(send)),
+            limits(limits)
+        {}
+
+        /// Takes the pending batch, requires the lock
+        std::string take() {
+          std::string batch;
+          if (1 == count) {
+            // No array for a single message
+            batch = pending.substr(1);
+          }
+          else if (count > 1) {
+            pending += ']';
+            batch = std::move(pending);
+          }
+
+          pending.clear();
+          count = 0;
+          return batch;
+        }
+
+        void startWindow() {
+          Ptr self = shared_from_this();
+          boost::asio::post(strand, [self]() {
+            self->timer.expires_after(self->limits.window);
+            self->timer.async_wait([self](const boost::system::error_code& error) {
+              if (error == boost::asio::error::operation_aborted) {
+                return;
+              }
+
+              {
+                std::lock_guard<std::mutex> lock(self->m);
+                self->armed = false;
+              }
+
+              self->flush();
+            });
+          });
+        }
+
+        /// Serializes the window timer
+        boost::asio::strand<boost::asio::any_io_executor> strand;
+
+        /// Window timer
+        boost::asio::steady_timer timer;
+
+        /// Send action
+        send_action_t send;
+
+        /// Batch limits
+        Limits limits;
+
+        /// Guards the pending batch
+        std::mutex m;
+
+        /// Serialized pending batch
+        std::string pending;
+
+        /// Amount of pending messages
+        std::size_t count = 0;
+
+        /// The window timer is running
+        bool armed = false;
+    };
+  }
+}
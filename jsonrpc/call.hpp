@@ -1,39 +1,84 @@
 #pragma once
 
 #include <condition_variable>
+#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <sstream>
+#include <type_traits>
 
 #include <boost/json.hpp>
 #include <boost/log/trivial.hpp>
 
+#include "call_store.hpp"
+#include "error.hpp"
 #include "notification.hpp"
 #include "request.hpp"
 #include "response_handler.hpp"
 #include "error_handler.hpp"
+#include "util/timerwheel.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
+    /**
+     * @brief Call log
+     *
+     * Table of the pending calls, that wait for their response. The calls
+     * are kept in a store with fine grained locks, so concurrent calls and
+     * responses rarely contend. Integral ids use a directly indexed ring,
+     * see \ref DefaultCallStore.
+     *
+     * A call needs to be registered before its request is sent. The response
+     * then releases the waiter directly.
+     *
+     * Calls can have a deadline, which is managed by a timer wheel. An
+     * expired or cancelled call is removed from the table and completed with
+     * an error response (\ref error::CallTimeout or \ref error::CallCancelled).
+     *
+     * @tparam TId Data type of the request id.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
     template <typename TId>
     class CallLog {
       public:
+        /// Completion handler of a call, that does not block a thread
+        using handler_t = std::function<void(const boost::json::object&)>;
+
+        /// Timeout of a call, zero disables the deadline
+        using timeout_t = util::TimerWheel::clock_t::duration;
+
         struct AwaitResponse {
-            inline explicit AwaitResponse(TId id)
-              : id(id)
+            inline explicit AwaitResponse(TId id, handler_t handler = handler_t())
+              : id(id),
+                handler(std::move(handler))
             {}
 
             TId id;
+            handler_t handler;
             bool available = false;
             boost::json::object response;
             std::condition_variable cv;
             std::mutex m;
 
+            /// Deadline of the call
+            util::TimerWheel::Node deadline;
+
             inline void wait() {
               std::unique_lock<std::mutex> lock(m);
               cv.wait(lock, [this]() { return available; });
             }
 
             inline void release(const boost::json::object& o) {
+              if ( handler ) {
+                // Nobody waits, complete the call directly
+                handler(o);
+                return;
+              }
+
               std::unique_lock<std::mutex> lock(m);
               available = true;
               response = o;
@@ -41,41 +86,213 @@ namespace ts7 {
             }
         };
 
+        using waiter_t = std::shared_ptr<AwaitResponse>;
+
+        /// Store of the pending calls
+        using store_t = typename DefaultCallStore<TId, waiter_t>::type;
+
+        /**
+         * @brief Register
+         *
+         * Adds a pending call for the id of the request. This needs to happen
+         * before the request is sent, so the response always finds its waiter.
+         *
+         * @param request The request that is about to be sent.
+         * @param timeout Deadline of the call, zero for none.
+         *
+         * @return Returns the waiter of the call. Returns an empty pointer, if
+         * the request has no valid id.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static waiter_t Register(const boost::json::object& request, timeout_t timeout = timeout_t::zero()) {
+          const boost::json::value* id_value = request.if_contains("id");
+          if ( !id_value ) {
+            return waiter_t();
+          }
+
+          ts7::jsonrpc::util::FromJson<TId> conv;
+          typename ts7::jsonrpc::util::FromJson<TId>::conversion_failure id = conv(*id_value);
+          if ( !id ) {
+            return waiter_t();
+          }
+
+          return Register(id.getSuccess(), timeout);
+        }
+
+        /// Adds a pending call for \p id, an already pending call is reused
+        static waiter_t Register(const TId& id, timeout_t timeout = timeout_t::zero()) {
+          waiter_t waiter = std::make_shared<AwaitResponse>(id);
+          waiter_t stored = Store().emplace(id, waiter);
+          if ( stored != waiter ) {
+            return stored;
+          }
+
+          Arm(waiter, timeout);
+          return waiter;
+        }
+
+        /**
+         * @brief Register with handler
+         *
+         * Adds a pending call, that is completed by \p handler instead of a
+         * waiting thread. The handler is called by the thread, that releases
+         * the call.
+         *
+         * @param id The id of the request, that is about to be sent.
+         * @param handler The completion handler.
+         * @param timeout Deadline of the call, zero for none.
+         *
+         * @return Returns false, if a call with the same id is already pending.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static bool Register(const TId& id, handler_t handler, timeout_t timeout = timeout_t::zero()) {
+          waiter_t waiter = std::make_shared<AwaitResponse>(id, std::move(handler));
+          if ( Store().emplace(id, waiter) != waiter ) {
+            return false;
+          }
+
+          Arm(waiter, timeout);
+          return true;
+        }
+
+        /// Removes a pending call, that will not wait for its response anymore, returns false if it was not pending
+        static bool Unregister(const TId& id) {
+          waiter_t waiter = Store().take(id);
+          if ( !waiter ) {
+            return false;
+          }
+
+          Timers().cancel(waiter->deadline);
+          return true;
+        }
+
         static boost::json::object Wait(const boost::json::object& request) {
-          std::shared_ptr<AwaitResponse> condition = GetWaitRequest(request);
+          waiter_t condition = Register(request);
           if ( !condition ) {
             /// @todo What to do in this case? Should never happen
             return boost::json::object();
           }
 
+          return Wait(condition);
+        }
+
+        static boost::json::object Wait(const waiter_t& condition) {
+          if ( !condition ) {
+            return boost::json::object();
+          }
+
           condition->wait();
-          calls.erase(condition->id);
           return condition->response;
         }
 
-        static void Release(const boost::json::object& response) {
+        /**
+         * @brief Release
+         *
+         * Hands the response to the waiter of the call and removes the call
+         * from the table.
+         *
+         * @param response The received response or error.
+         *
+         * @return Returns false, if no call is pending for the id.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static bool Release(const boost::json::object& response) {
+          const boost::json::value* id_value = response.if_contains("id");
+          if ( !id_value ) {
+            return false;
+          }
+
           ts7::jsonrpc::util::FromJson<TId> conv;
-          TId id = conv(response.at("id"));
+          typename ts7::jsonrpc::util::FromJson<TId>::conversion_failure id = conv(*id_value);
+          if ( !id ) {
+            return false;
+          }
+
+          waiter_t waiter = Store().take(id.getSuccess());
+          if ( !waiter ) {
+            BOOST_LOG_TRIVIAL(warning) << "Response for unknown call received: " << response;
+            return false;
+          }
+
+          // Wake the waiter outside of the store lock
+          Timers().cancel(waiter->deadline);
+          waiter->release(response);
+          return true;
+        }
 
-          while( calls.find(id) == calls.end() ) {
-            // Wait for the call to be added
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        /**
+         * @brief Cancel
+         *
+         * Removes a pending call and completes it with \ref error::CallCancelled.
+         * A response, that arrives later, is ignored.
+         *
+         * @param id The id of the call.
+         *
+         * @return Returns false, if no call is pending for the id.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static bool Cancel(const TId& id) {
+          waiter_t waiter = Store().take(id);
+          if ( !waiter ) {
+            return false;
           }
 
-          std::shared_ptr<AwaitResponse> ptr = calls[id];
-          ptr->release(response);
+          Timers().cancel(waiter->deadline);
+          Complete(waiter, error::CallCancelled());
+          return true;
+        }
+
+        /// Returns the amount of calls with an armed deadline
+        static std::size_t Deadlines() {
+          return Timers().size();
         }
 
       protected:
-        static std::shared_ptr<AwaitResponse> GetWaitRequest(const boost::json::object& request) {
-          ts7::jsonrpc::util::FromJson<TId> conv;
-          TId id = conv(request.at("id"));
+        static inline store_t& Store() {
+          static store_t store;
+          return store;
+        }
 
-          if ( calls.find(id) == calls.end()) {
-            calls[id] = std::shared_ptr<AwaitResponse>(new AwaitResponse{id});
+        static inline util::TimerService& Timers() {
+          static util::TimerService timers;
+          return timers;
+        }
+
+        static void Arm(const waiter_t& waiter, timeout_t timeout) {
+          if ( timeout <= timeout_t::zero() ) {
+            return;
           }
 
-          return calls[id];
+          // The timer must not keep the call alive, the table owns it
+          std::weak_ptr<AwaitResponse> weak = waiter;
+          Timers().schedule(waiter->deadline, timeout, [weak]() {
+            waiter_t expired = weak.lock();
+            if ( !expired ) {
+              return;
+            }
+
+            if ( Store().take(expired->id, expired) ) {
+              Complete(expired, error::CallTimeout());
+            }
+          });
+        }
+
+        /// Completes the call with an error response
+        static void Complete(const waiter_t& waiter, const error::ErrorCode& code) {
+          Error<TId> error;
+          waiter->release(error(waiter->id, code));
         }
 
         static inline std::string PointerAddress(const void* p) {
@@ -83,12 +300,88 @@ namespace ts7 {
           ss << p;
           return ss.str();
         }
-
-        static std::map<TId, std::shared_ptr<AwaitResponse>> calls;
     };
 
-    template <typename TId>
-    std::map<TId, std::shared_ptr<typename CallLog<TId>::AwaitResponse>> CallLog<TId>::calls = std::map<TId, std::shared_ptr<AwaitResponse>>();
+    /**
+     * @brief Call result
+     *
+     * Converts a received response or error to the result of a call.
+     *
+     * @tparam TRet Data type of the result.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TRet>
+    struct CallResult {
+        using maybe_failed = error::maybe_failed<TRet, error::ErrorCode>;
+
+        /**
+         * @brief From response
+         *
+         * @param response The received response or error.
+         *
+         * @return Returns the converted result, the received error or the
+         * error that describes why the response is invalid.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static maybe_failed From(const boost::json::object& response) {
+          if ( const boost::json::value* result = response.if_contains("result") ) {
+            if constexpr (std::is_void<TRet>::value) {
+              return maybe_failed();
+            }
+            else {
+              util::FromJson<TRet> conv;
+              typename util::FromJson<TRet>::conversion_failure converted = conv(*result);
+              if ( !converted ) {
+                return error::ResultWrongType(util::GetJsonType(*result), util::AsJson<TRet>::type);
+              }
+
+              return maybe_failed(converted.getSuccess());
+            }
+          }
+
+          const boost::json::value* e = response.if_contains("error");
+          if ( !e ) {
+            return error::ResultMissing();
+          }
+
+          if ( !e->is_object() ) {
+            return error::ErrorNotAnObject(util::GetJsonType(*e));
+          }
+
+          const boost::json::object& o = e->as_object();
+          const boost::json::value* code = o.if_contains("code");
+          if ( !code ) {
+            return error::ErrorCodeMissing();
+          }
+
+          if ( !code->is_int64() ) {
+            return error::ErrorCodeNotANumber(util::GetJsonType(*code));
+          }
+
+          const boost::json::value* message = o.if_contains("message");
+          if ( !message ) {
+            return error::ErrorMessageMissing();
+          }
+
+          if ( !message->is_string() ) {
+            return error::ErrorMessageNotAString(util::GetJsonType(*message));
+          }
+
+          const boost::json::string& text = message->get_string();
+          const boost::json::value* data = o.if_contains("data");
+          return error::ErrorCode(
+            static_cast<std::int32_t>(code->get_int64()),
+            std::string(text.data(), text.size()),
+            data ? *data : boost::json::value()
+          );
+        }
+    };
 
     template <typename TId, typename TRet, typename TErrorData, typename... TArgs>
     class Call {
@@ -114,12 +407,14 @@ namespace ts7 {
           std::future<void> f = std::async(std::launch::async, [this, args...]() {
             // Generate and transmit request
             boost::json::object requestObject = request(args...);
+            // Register before sending, the response may arrive immediately
+            typename CallLog<typename TId::type>::waiter_t waiter = CallLog<typename TId::type>::Register(requestObject, timeout);
             if ( request_action ) {
               request_action(requestObject);
             }
 
             // Block until a response is received
-            boost::json::object responseObject = CallLog<typename TId::type>::Wait(requestObject);
+            boost::json::object responseObject = CallLog<typename TId::type>::Wait(waiter);
 
             if ( responseObject.contains("result") ) {
               typename response_t::maybe_failed succeeded = responseHandler(responseObject);
@@ -142,18 +437,42 @@ namespace ts7 {
           return f;
         }
 
+        /// Sets the deadline of the calls, zero disables it
+        void setTimeout(typename CallLog<typename TId::type>::timeout_t t) {
+          timeout = t;
+        }
+
       protected:
         request_t request;
         request_action_t request_action;
         response_t responseHandler;
         error_t errorHandler;
+        typename CallLog<typename TId::type>::timeout_t timeout = CallLog<typename TId::type>::timeout_t::zero();
     };
 
+    /**
+     * @brief Synchronous call
+     *
+     * Call that blocks the calling thread until the response arrived. The
+     * calling thread sends the request and waits on the entry of the call in
+     * the \ref CallLog, no further thread is involved. The result is kept
+     * per call, so a SyncCall may be used from several threads at once.
+     *
+     * @tparam TId Request id generator, e.g. \ref RequestID.
+     * @tparam TRet Data type of the result.
+     * @tparam TErrorData Data type of the error data.
+     * @tparam TArgs Data types of the parameters.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
     template <typename TId, typename TRet, typename TErrorData, typename... TArgs>
-    class SyncCall : public Call<TId, TRet, TErrorData, TArgs...> {
+    class SyncCall {
       public:
         using request_t = Request<TId, TArgs...>;
         using request_action_t = std::function<void(const boost::json::object&)>;
+        using log_t = CallLog<typename TId::type>;
 
         using response_t = ResponseHandler<typename TId::type, TRet>;
         using response_action_t = typename ResponseHandler<typename TId::type, TRet>::callback_t;
@@ -161,69 +480,82 @@ namespace ts7 {
         using error_t = ErrorHandler<typename TId::type, TErrorData>;
         using error_action_t = typename ErrorHandler<typename TId::type, TErrorData>::callback_t;
 
+        using result_t = error::maybe_failed<TRet, error::ErrorCode>;
+
         template <typename... UArgs>
         SyncCall(const std::string& method, request_action_t request_action, UArgs... args)
           : request(method, args...),
-            request_action(request_action),
-            responseHandler([this](const typename TId::type& id, const TRet& ret) -> void {
-              responses[id] = ret;
-            }),
-            errorHandler([this](const typename TId::type& id, std::int32_t code, const std::string& message, const TErrorData& data) -> void {
-              responses[id] = error::ErrorCode(code, message, data);
-            })
+            request_action(request_action)
         {}
 
-        error::maybe_failed<TRet, error::ErrorCode> operator()(TArgs... args) {
-          typename TId::type request_id;
+        result_t operator()(TArgs... args) {
+          if ( !request_action ) {
+            // The call could never be finished
+            return error::NotYetImplemented();
+          }
 
-          std::future<void> f = std::async(std::launch::async, [this, &request_id, args...]() {
-            // Generate and transmit request
-            boost::json::object requestObject = request(args...);
+          // Generate and transmit request
+          boost::json::object requestObject = request(args...);
 
-            util::FromJson<typename TId::type> id_conv;
-            request_id = id_conv(request.at("id")).getSuccess();
+          // Register before sending, the response may arrive immediately
+          typename log_t::waiter_t waiter = log_t::Register(requestObject, timeout);
+          request_action(requestObject);
 
-            if ( request_action ) {
-              request_action(requestObject);
-            }
+          // Block the calling thread until a response is received
+          return handle(log_t::Wait(waiter));
+        }
 
-            // Block until a response is received
-            boost::json::object responseObject = CallLog<typename TId::type>::Wait(requestObject);
+        void setAction(request_action_t action) {
+          request_action = action;
+        }
 
-            if ( responseObject.contains("result") ) {
-              typename response_t::maybe_failed succeeded = responseHandler(responseObject);
-              if ( !succeeded ) {
-                BOOST_LOG_TRIVIAL(error) << "Response handling failed: " << static_cast<std::string>(succeeded.getFailed());
-              }
-            }
-            else if ( responseObject.contains("error") ) {
-              typename error_t::maybe_failed succeeded = errorHandler(responseObject);
-              if ( !succeeded ) {
-                BOOST_LOG_TRIVIAL(error) << "Error handling failed: " << static_cast<std::string>(succeeded.getFailed());
+        const std::string& getMethod() const {
+          return request.getMethod();
+        }
 
-              }
-            }
-            else {
-              throw std::runtime_error("Unknown response type");
-            }
-          });
+        void setMethod(const std::string& method) {
+          request.setMethod(method);
+        }
 
-          // Wait for async process to finish
-          f.wait();
+        /// Sets the deadline of the calls, zero disables it
+        void setTimeout(typename log_t::timeout_t t) {
+          timeout = t;
+        }
 
-          // Get copy and remove entry
-          error::maybe_failed<TRet, error::ErrorCode> result = responses[request_id];
-          responses.erase(request_id);
+      protected:
+        /// Converts the response into the result of this call
+        result_t handle(const boost::json::object& responseObject) const {
+          result_t result = error::ResultMissing();
+
+          if ( responseObject.contains("result") ) {
+            response_t responseHandler([&result](const typename TId::type&, const TRet& ret) -> void {
+              result = result_t(ret);
+            });
+
+            typename response_t::maybe_failed succeeded = responseHandler(responseObject);
+            if ( !succeeded ) {
+              BOOST_LOG_TRIVIAL(error) << "Response handling failed: " << static_cast<std::string>(succeeded.getFailed());
+              return succeeded.getFailed();
+            }
+          }
+          else if ( responseObject.contains("error") ) {
+            error_t errorHandler([&result](const typename TId::type&, std::int32_t code, const std::string& message, const TErrorData& data) -> void {
+              result = result_t(error::ErrorCode(code, std::string(message), boost::json::value(util::AsJson<TErrorData>(data))));
+            });
+
+            typename error_t::maybe_failed succeeded = errorHandler(responseObject);
+            if ( !succeeded ) {
+              BOOST_LOG_TRIVIAL(error) << "Error handling failed: " << static_cast<std::string>(succeeded.getFailed());
+              return succeeded.getFailed();
+            }
+          }
 
           return result;
         }
 
-      protected:
         request_t request;
         request_action_t request_action;
-        response_t responseHandler;
-        error_t errorHandler;
-        std::map<typename TId::type, error::maybe_failed<TRet, error::ErrorCode>> responses;
+        typename log_t::timeout_t timeout = log_t::timeout_t::zero();
     };
 
     template <typename TId, typename TRet, typename... TArgs>
@@ -231,6 +563,7 @@ namespace ts7 {
       public:
         using request_t = Request<TId, TArgs...>;
         using request_action_t = std::function<void(const boost::json::object&)>;
+        using log_t = CallLog<typename TId::type>;
 
         using response_t = ResponseHandler<typename TId::type, TRet>;
         using response_action_t = typename ResponseHandler<typename TId::type, TRet>::callback_t;
@@ -238,66 +571,29 @@ namespace ts7 {
         using error_t = ErrorHandler<typename TId::type, void>;
         using error_action_t = typename ErrorHandler<typename TId::type, void>::callback_t;
 
+        using result_t = error::maybe_failed<TRet, error::ErrorCode>;
+
         template <typename... UArgs>
         SyncCall(const std::string& method, request_action_t request_action, UArgs... args)
           : request(method, args...),
-            request_action(request_action),
-            responseHandler([this](const typename TId::type& id, const TRet& ret) -> void {
-              responses[id] = error::maybe_failed<TRet, error::ErrorCode>(ret);
-            }),
-            errorHandler([this](const typename TId::type& id, std::int32_t code, const std::string& message) -> void {
-              responses[id] = error::maybe_failed<TRet, error::ErrorCode>(error::ErrorCode(code, std::string(message)));
-            })
+            request_action(request_action)
         {}
 
-        error::maybe_failed<TRet, error::ErrorCode> operator()(TArgs... args) {
-          typename TId::type request_id;
-
+        result_t operator()(TArgs... args) {
           if ( !request_action ) {
-            // Avoid running a new thread for a call that can't be finished
+            // The call could never be finished
             return error::NotYetImplemented();
           }
 
-          std::future<void> f = std::async(std::launch::async, [this, &request_id, args...]() {
-            // Generate and transmit request
-            boost::json::object requestObject = request(args...);
-
-            util::FromJson<typename TId::type> id_conv;
-            request_id = id_conv(requestObject.at("id")).getSuccess();
+          // Generate and transmit request
+          boost::json::object requestObject = request(args...);
 
-            if ( request_action ) {
-              request_action(requestObject);
-            }
+          // Register before sending, the response may arrive immediately
+          typename log_t::waiter_t waiter = log_t::Register(requestObject, timeout);
+          request_action(requestObject);
 
-            // Block until a response is received
-            boost::json::object responseObject = CallLog<typename TId::type>::Wait(requestObject);
-
-            if ( responseObject.contains("result") ) {
-              typename response_t::maybe_failed succeeded = responseHandler(responseObject);
-              if ( !succeeded ) {
-                BOOST_LOG_TRIVIAL(error) << "Response handling failed: " << static_cast<std::string>(succeeded.getFailed());
-              }
-            }
-            else if ( responseObject.contains("error") ) {
-              typename error_t::maybe_failed succeeded = errorHandler(responseObject);
-              if ( !succeeded ) {
-                BOOST_LOG_TRIVIAL(error) << "Error handling failed: " << static_cast<std::string>(succeeded.getFailed());
-
-              }
-            }
-            else {
-              throw std::runtime_error("Unknown response type");
-            }
-          });
-
-          // Wait for async process to finish
-          f.wait();
-
-          // Get copy and remove entry
-          error::maybe_failed<TRet, error::ErrorCode> result = responses[request_id];
-          responses.erase(request_id);
-
-          return result;
+          // Block the calling thread until a response is received
+          return handle(log_t::Wait(waiter));
         }
 
         void setAction(request_action_t action) {
@@ -312,12 +608,45 @@ namespace ts7 {
           request.setMethod(method);
         }
 
+        /// Sets the deadline of the calls, zero disables it
+        void setTimeout(typename log_t::timeout_t t) {
+          timeout = t;
+        }
+
       protected:
+        /// Converts the response into the result of this call
+        result_t handle(const boost::json::object& responseObject) const {
+          result_t result = error::ResultMissing();
+
+          if ( responseObject.contains("result") ) {
+            response_t responseHandler([&result](const typename TId::type&, const TRet& ret) -> void {
+              result = result_t(ret);
+            });
+
+            typename response_t::maybe_failed succeeded = responseHandler(responseObject);
+            if ( !succeeded ) {
+              BOOST_LOG_TRIVIAL(error) << "Response handling failed: " << static_cast<std::string>(succeeded.getFailed());
+              return succeeded.getFailed();
+            }
+          }
+          else if ( responseObject.contains("error") ) {
+            error_t errorHandler([&result](const typename TId::type&, std::int32_t code, const std::string& message) -> void {
+              result = result_t(error::ErrorCode(code, std::string(message)));
+            });
+
+            typename error_t::maybe_failed succeeded = errorHandler(responseObject);
+            if ( !succeeded ) {
+              BOOST_LOG_TRIVIAL(error) << "Error handling failed: " << static_cast<std::string>(succeeded.getFailed());
+              return succeeded.getFailed();
+            }
+          }
+
+          return result;
+        }
+
         request_t request;
         request_action_t request_action;
-        response_t responseHandler;
-        error_t errorHandler;
-        std::map<typename TId::type, error::maybe_failed<TRet, error::ErrorCode>> responses;
+        typename log_t::timeout_t timeout = log_t::timeout_t::zero();
     };
   }
 }
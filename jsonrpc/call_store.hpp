@@ -0,0 +1,272 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace ts7 {
+  namespace jsonrpc {
+    /**
+     * @brief Sharded call store
+     *
+     * Pending call store for any kind of id. The calls are spread over
+     * shards, which are hash maps with their own lock.
+     *
+     * @tparam TId Data type of the request id.
+     * @tparam TValue Data type of the stored calls, needs to be nullable.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TId, typename TValue>
+    class ShardedCallStore {
+      public:
+        /// Amount of independent shards
+        static constexpr const std::size_t shard_count = 16;
+
+        /**
+         * @brief Emplace
+         *
+         * Stores \p value for \p id, if no call is stored for it yet.
+         *
+         * @return Returns the stored value, which is the already pending
+         * call for duplicate ids.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        TValue emplace(const TId& id, const TValue& value) {
+          Shard& shard = getShard(id);
+          std::lock_guard<std::mutex> lock(shard.m);
+
+          return shard.calls.emplace(id, value).first->second;
+        }
+
+        /// Returns the call of \p id without removing it, empty if there is none
+        TValue find(const TId& id) {
+          Shard& shard = getShard(id);
+          std::lock_guard<std::mutex> lock(shard.m);
+
+          typename std::unordered_map<TId, TValue>::const_iterator it = shard.calls.find(id);
+          return ( it == shard.calls.end() ) ? TValue() : it->second;
+        }
+
+        /// Removes and returns the call of \p id, empty if there is none
+        TValue take(const TId& id) {
+          Shard& shard = getShard(id);
+          std::lock_guard<std::mutex> lock(shard.m);
+
+          typename std::unordered_map<TId, TValue>::iterator it = shard.calls.find(id);
+          if ( it == shard.calls.end() ) {
+            return TValue();
+          }
+
+          TValue value = std::move(it->second);
+          shard.calls.erase(it);
+          return value;
+        }
+
+        /// Removes the call of \p id, if it is still \p value
+        bool take(const TId& id, const TValue& value) {
+          Shard& shard = getShard(id);
+          std::lock_guard<std::mutex> lock(shard.m);
+
+          typename std::unordered_map<TId, TValue>::iterator it = shard.calls.find(id);
+          if ( it == shard.calls.end() || it->second != value ) {
+            return false;
+          }
+
+          shard.calls.erase(it);
+          return true;
+        }
+
+      protected:
+        struct Shard {
+            std::mutex m;
+            std::unordered_map<TId, TValue> calls;
+        };
+
+        inline Shard& getShard(const TId& id) {
+          return shards[std::hash<TId>{}(id) % shard_count];
+        }
+
+        Shard shards[shard_count];
+    };
+
+    /**
+     * @brief Ring call store
+     *
+     * Pending call store for mostly dense integral ids, e.g. the per-thread
+     * blocks of \ref RequestID. The calls are stored in a ring of 2^TBits
+     * slots, that is directly indexed by the lower bits of the id. Storing,
+     * finding and removing a call is O(1) and does not allocate.
+     *
+     * Every slot keeps the complete id of its call. The upper bits act as
+     * generation of the slot: a response with a stale or unknown id does not
+     * match and is rejected. Ids, whose slot is still used by an older call,
+     * are outside the window of the ring and go to an overflow map, so ids
+     * that are not sequential are still handled correctly. This happens, if
+     * more calls are pending than the ring has slots, or if a thread still
+     * uses an old block while the others advanced by a whole ring. All
+     * operations on an id, including the ones on the overflow map, run under
+     * the lock of its slot, and the overflow map is only searched while it
+     * is not empty.
+     *
+     * @tparam TId Integral data type of the request id.
+     * @tparam TValue Data type of the stored calls, needs to be nullable.
+     * @tparam TBits Amount of bits of the ring index.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TId, typename TValue, std::size_t TBits = 12>
+    class RingCallStore {
+      static_assert(std::is_integral<TId>::value, "The ring call store requires integral ids");
+
+      public:
+        /// Amount of slots
+        static constexpr const std::size_t capacity = std::size_t(1) << TBits;
+
+        /// Amount of locks, that guard the slots
+        static constexpr const std::size_t lock_count = 64;
+
+        /// Stores \p value for \p id, see \ref ShardedCallStore::emplace
+        TValue emplace(const TId& id, const TValue& value) {
+          Slot& slot = getSlot(id);
+          std::lock_guard<std::mutex> lock(getLock(id));
+          if ( !slot.value ) {
+            // The id may have overflowed, while the slot was used by an older call
+            if ( hasOverflow() ) {
+              TValue pending = overflow.find(id);
+              if ( pending ) {
+                // Duplicate id
+                return pending;
+              }
+            }
+
+            slot.id = id;
+            slot.value = value;
+            return value;
+          }
+
+          if ( slot.id == id ) {
+            // Duplicate id
+            return slot.value;
+          }
+
+          // The slot belongs to an older call
+          TValue stored = overflow.emplace(id, value);
+          if ( stored == value ) {
+            overflowed.fetch_add(1, std::memory_order_relaxed);
+          }
+
+          return stored;
+        }
+
+        /// Removes and returns the call of \p id, empty if there is none
+        TValue take(const TId& id) {
+          Slot& slot = getSlot(id);
+          std::lock_guard<std::mutex> lock(getLock(id));
+          if ( slot.value && slot.id == id ) {
+            return std::move(slot.value);
+          }
+
+          if ( !hasOverflow() ) {
+            return TValue();
+          }
+
+          TValue value = overflow.take(id);
+          if ( value ) {
+            overflowed.fetch_sub(1, std::memory_order_relaxed);
+          }
+
+          return value;
+        }
+
+        /// Removes the call of \p id, if it is still \p value
+        bool take(const TId& id, const TValue& value) {
+          Slot& slot = getSlot(id);
+          std::lock_guard<std::mutex> lock(getLock(id));
+          if ( slot.value && slot.id == id ) {
+            if ( slot.value != value ) {
+              return false;
+            }
+
+            slot.value = TValue();
+            return true;
+          }
+
+          if ( !hasOverflow() || !overflow.take(id, value) ) {
+            return false;
+          }
+
+          overflowed.fetch_sub(1, std::memory_order_relaxed);
+          return true;
+        }
+
+      protected:
+        struct Slot {
+            TId id = TId();
+            TValue value;
+        };
+
+        static inline std::size_t Index(const TId& id) {
+          return static_cast<std::size_t>(id) & (capacity - 1);
+        }
+
+        inline Slot& getSlot(const TId& id) {
+          return slots[Index(id)];
+        }
+
+        /// True, if calls are stored in the overflow map
+        inline bool hasOverflow() const {
+          // Overflowing calls of the locked slot were counted under the same lock
+          return overflowed.load(std::memory_order_relaxed) > 0;
+        }
+
+        /// Neighbouring slots use different locks
+        inline std::mutex& getLock(const TId& id) {
+          return locks[Index(id) & (lock_count - 1)];
+        }
+
+        /// Directly indexed slots
+        Slot slots[capacity];
+
+        /// Guards the slots
+        std::mutex locks[lock_count];
+
+        /// Calls outside of the window of the ring
+        ShardedCallStore<TId, TValue> overflow;
+
+        /// Amount of calls in \ref overflow
+        std::atomic<std::size_t> overflowed{0};
+    };
+
+    /**
+     * @brief Default call store
+     *
+     * Selects the pending call store of the \ref CallLog. Integral ids use
+     * the \ref RingCallStore, all other ids the \ref ShardedCallStore.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TId, typename TValue, typename = void>
+    struct DefaultCallStore {
+        using type = ShardedCallStore<TId, TValue>;
+    };
+
+    template <typename TId, typename TValue>
+    struct DefaultCallStore<TId, TValue, typename std::enable_if<std::is_integral<TId>::value && !std::is_same<TId, bool>::value>::type> {
+        using type = RingCallStore<TId, TValue>;
+    };
+  }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/log/trivial.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace com {
+      /**
+       * @brief IO context pool
+       *
+       * Set of IO contexts, each run by its own thread. Connections are
+       * assigned round robin, so the socket I/O of the connections is spread
+       * over all threads while every connection stays on one thread.
+       *
+       * @code
+       * com::IoContextPool contexts;
+       * com::TcpServer<std::int32_t, Owner> server(&owner, contexts, 9200);
+       * server.startAccept();
+       * contexts.run();
+       * @endcode
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class IoContextPool {
+        public:
+          using work_guard_t = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+          /**
+           * @brief constructor
+           *
+           * @param size Amount of IO contexts, zero uses one per core.
+           * @param pin Pins the thread of every IO context to one core.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit IoContextPool(std::size_t size = 0, bool pin = true)
+            : pin(pin)
+          {
+            if (0 == size) {
+              size = std::thread::hardware_concurrency();
+            }
+
+            if (0 == size) {
+              size = 1;
+            }
+
+            for (std::size_t i = 0; i < size; ++i) {
+              // Every context is run by a single thread
+              contexts.emplace_back(new boost::asio::io_context(1));
+              guards.emplace_back(contexts.back()->get_executor());
+            }
+          }
+
+          IoContextPool(const IoContextPool&) = delete;
+          IoContextPool& operator=(const IoContextPool&) = delete;
+
+          inline ~IoContextPool() {
+            stop();
+          }
+
+          /**
+           * @brief Run
+           *
+           * Starts one thread per IO context and returns immediately.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void run() {
+            for (std::size_t i = 0; i < contexts.size(); ++i) {
+              threads.emplace_back([this, i]() {
+                if (pin) {
+                  Pin(i);
+                }
+
+                contexts[i]->run();
+              });
+            }
+          }
+
+          /**
+           * @brief Stop
+           *
+           * Stops all IO contexts and waits for their threads.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void stop() {
+            guards.clear();
+            for (std::unique_ptr<boost::asio::io_context>& ctx : contexts) {
+              ctx->stop();
+            }
+
+            for (std::thread& thread : threads) {
+              if (thread.joinable()) {
+                thread.join();
+              }
+            }
+
+            threads.clear();
+          }
+
+          /// Returns the next IO context in round robin order
+          inline boost::asio::io_context& next() {
+            return *contexts[nextContext.fetch_add(1, std::memory_order_relaxed) % contexts.size()];
+          }
+
+          inline boost::asio::io_context& get(std::size_t index) {
+            return *contexts.at(index);
+          }
+
+          inline std::size_t size() const {
+            return contexts.size();
+          }
+
+        protected:
+          /// Pins the calling thread to the core \p index
+          static inline void Pin(std::size_t index) {
+#ifdef __linux__
+            const unsigned int cores = std::thread::hardware_concurrency();
+            if (0 == cores) {
+              return;
+            }
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(index % cores, &set);
+            if (0 != pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+              BOOST_LOG_TRIVIAL(warning) << "Could not pin IO thread " << index;
+            }
+#else
+            (void)index;
+#endif
+          }
+
+          /// Pin the threads to cores
+          const bool pin;
+
+          /// IO contexts
+          std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+
+          /// Keep the contexts running without work
+          std::vector<work_guard_t> guards;
+
+          /// Threads of the contexts
+          std::vector<std::thread> threads;
+
+          /// Next context for round robin
+          std::atomic<std::size_t> nextContext{0};
+      };
+    }
+  }
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/json.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "../call.hpp"
+#include "../util/executor.hpp"
+
+#include "tcpconnection.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace com {
+      /**
+       * @brief TCP client
+       *
+       * Client transport, that multiplexes any amount of concurrent calls
+       * over a pool of TCP connections to one endpoint. Requests are not
+       * bound to a connection: the responses are matched by their id
+       * through the \ref CallLog, so calls never wait for each other.
+       *
+       * Every request is sent on the connection with the least outstanding
+       * responses. The connections are regular \ref TcpConnection instances,
+       * so framing, wire format detection and writing are shared with the
+       * server.
+       *
+       * @code
+       * com::TcpClient<std::int32_t> client(ctx, "localhost", 9200, 4);
+       * client.connect();
+       * AsyncCall<RequestID<std::int32_t>, std::int32_t, std::int32_t, std::int32_t> sum(ctx.get_executor(), "sum", client.requestAction(), "a", "b");
+       * @endcode
+       *
+       * @note Requests sent by the server are ignored, the client does not
+       * provide procedures.
+       *
+       * @tparam TId Data type of the request ids.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename TId>
+      class TcpClient {
+        public:
+          using log_t = CallLog<TId>;
+          using request_action_t = std::function<void(const boost::json::object&)>;
+
+          /**
+           * @brief Slot
+           *
+           * One connection of the pool. It is the owner of its connection and
+           * tracks the ids of the responses, that are outstanding on it. When
+           * the connection gets closed, these calls are cancelled.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          class Slot {
+            public:
+              using connection_t = TcpConnection<TId, Slot>;
+
+              inline Slot() = default;
+              Slot(const Slot&) = delete;
+              Slot& operator=(const Slot&) = delete;
+
+              inline void registerCall(typename connection_t::Ptr) {}
+
+              inline void releaseCall() {}
+
+              inline void responseReceived(const boost::json::object& o) {
+                received(o);
+              }
+
+              inline void errorReceived(const boost::json::object& o) {
+                received(o);
+              }
+
+              /// Returns the amount of outstanding responses
+              inline std::size_t getOutstanding() const {
+                return outstanding.load(std::memory_order_relaxed);
+              }
+
+              inline bool isConnected() const {
+                return connected.load(std::memory_order_acquire);
+              }
+
+            protected:
+              friend class TcpClient;
+
+              /// Tracks \p id as outstanding on this connection
+              void sent(const TId& id) {
+                std::lock_guard<std::mutex> lock(m);
+                if (ids.insert(id).second) {
+                  outstanding.fetch_add(1, std::memory_order_relaxed);
+                }
+              }
+
+              void received(const boost::json::object& o) {
+                const boost::json::value* id = o.if_contains("id");
+                if (nullptr != id) {
+                  util::FromJson<TId> id_conv;
+                  typename util::FromJson<TId>::conversion_failure converted = id_conv(*id);
+
+                  // Responses of timed out calls are still tracked, they were sent here
+                  std::lock_guard<std::mutex> lock(m);
+                  if (converted && ids.erase(converted.getSuccess()) > 0) {
+                    outstanding.fetch_sub(1, std::memory_order_relaxed);
+                  }
+                }
+
+                log_t::Release(o);
+              }
+
+              /// Takes the connection out of the pool and cancels its outstanding calls
+              void closed() {
+                connected.store(false, std::memory_order_release);
+
+                std::set<TId> cancelled;
+                {
+                  std::lock_guard<std::mutex> lock(m);
+                  cancelled.swap(ids);
+                  outstanding.store(0, std::memory_order_relaxed);
+                }
+
+                for (const TId& id : cancelled) {
+                  log_t::Cancel(id);
+                }
+              }
+
+              /// The connection
+              typename connection_t::Ptr conn;
+
+              /// Host and port of the server, for logging
+              std::string endpoint;
+
+              /// Guards the outstanding ids
+              std::mutex m;
+
+              /// Ids of the outstanding responses
+              std::set<TId> ids;
+
+              /// Amount of outstanding responses
+              std::atomic<std::size_t> outstanding{0};
+
+              /// The connection is established
+              std::atomic<bool> connected{false};
+          };
+
+          /**
+           * @brief constructor
+           *
+           * @param ctx IO context of the connections.
+           * @param host Host name or address of the server.
+           * @param port Port of the server.
+           * @param pool_size Amount of connections to the server.
+           * @param executor Executor of the received responses. Without an
+           * executor the responses are handled by the IO context directly,
+           * releasing a call is short.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline TcpClient(boost::asio::io_context& ctx, const std::string& host, std::uint16_t port = 9200, std::size_t pool_size = 1, util::Executor* executor = nullptr)
+            : ctx(ctx),
+              host(host),
+              port(port),
+              executor(executor ? executor : &inlineExecutor)
+          {
+            for (std::size_t i = 0; i < (pool_size > 0 ? pool_size : 1); ++i) {
+              slots.push_back(std::make_shared<Slot>());
+              slots.back()->endpoint = host + ":" + std::to_string(port);
+            }
+          }
+
+          TcpClient(const TcpClient&) = delete;
+          TcpClient& operator=(const TcpClient&) = delete;
+
+          inline ~TcpClient() {
+            close();
+          }
+
+          /**
+           * @brief Connect
+           *
+           * Connects all connections of the pool and starts reading the
+           * responses. A connection, that the server closes, is taken out of
+           * the pool and its outstanding calls are cancelled.
+           *
+           * @throws boost::system::system_error, if resolving the host or
+           * connecting failed.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void connect() {
+            boost::asio::ip::tcp::resolver resolver(ctx);
+            const boost::asio::ip::tcp::resolver::results_type endpoints = resolver.resolve(host, std::to_string(port));
+
+            for (std::shared_ptr<Slot>& slot : slots) {
+              typename Slot::connection_t::Ptr conn = Slot::connection_t::Create(slot.get(), ctx, nullptr, executor);
+              boost::asio::connect(conn->socket(), endpoints);
+              conn->socket().set_option(boost::asio::ip::tcp::no_delay(true));
+
+              // The connection must not keep its slot alive
+              std::weak_ptr<Slot> weak = slot;
+              conn->connection_closed.add([weak](typename Slot::connection_t::id_t) {
+                if (std::shared_ptr<Slot> s = weak.lock()) {
+                  BOOST_LOG_TRIVIAL(warning) << "Connection to " << s->endpoint << " closed, cancelling " << s->getOutstanding() << " calls";
+                  s->closed();
+                }
+              });
+
+              slot->conn = conn;
+              slot->connected.store(true, std::memory_order_release);
+              conn->waitForRequest();
+
+              BOOST_LOG_TRIVIAL(debug) << "Connected client " << conn->getID() << " to " << host << ":" << port;
+            }
+          }
+
+          /**
+           * @brief Close
+           *
+           * Closes all connections of the pool.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void close() {
+            for (std::shared_ptr<Slot>& slot : slots) {
+              slot->connected.store(false, std::memory_order_release);
+              if (slot->conn) {
+                boost::system::error_code ignored;
+                slot->conn->socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                slot->conn->socket().close(ignored);
+              }
+            }
+          }
+
+          /**
+           * @brief Send
+           *
+           * Sends a request or notification on the connection with the least
+           * outstanding responses. It can be used as request action of
+           * \ref Call, \ref AsyncCall and \ref Notify.
+           *
+           * @note The call needs to be registered in the \ref CallLog before,
+           * which \ref Call and \ref AsyncCall do. If no connection is
+           * established, a pending call is cancelled. A connection, that
+           * failed to write, is no longer selected.
+           *
+           * @param message The request or notification.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void operator()(const boost::json::object& message) {
+            std::shared_ptr<Slot> slot = select();
+            const boost::json::value* id = message.if_contains("id");
+
+            if (nullptr == slot) {
+              BOOST_LOG_TRIVIAL(error) << "No connection to " << host << ":" << port;
+              cancel(id);
+              return;
+            }
+
+            if (nullptr == id) {
+              // Notifications are coalesced in the send queue
+              slot->conn->queue(boost::json::value(message));
+              return;
+            }
+
+            util::FromJson<TId> id_conv;
+            typename util::FromJson<TId>::conversion_failure converted = id_conv(*id);
+            if (converted) {
+              slot->sent(converted.getSuccess());
+            }
+
+            if (!slot->isConnected()) {
+              // Closed meanwhile, the id might have been tracked after the cancellation
+              slot->closed();
+              return;
+            }
+
+            // The slot outlives the client, if it is destroyed with pending writes
+            slot->conn->write(boost::json::value(message), [slot](const boost::system::error_code& error) {
+              if (error) {
+                BOOST_LOG_TRIVIAL(error) << "Write to " << slot->endpoint << " failed: " << error.message();
+                slot->closed();
+              }
+            });
+          }
+
+          /// Returns a request action, that sends through this client
+          inline request_action_t requestAction() {
+            return [this](const boost::json::object& message) {
+              (*this)(message);
+            };
+          }
+
+          inline std::size_t getPoolSize() const {
+            return slots.size();
+          }
+
+          inline const Slot& getSlot(std::size_t index) const {
+            return *slots.at(index);
+          }
+
+        protected:
+          /// Returns the connected slot with the least outstanding responses
+          std::shared_ptr<Slot> select() {
+            std::shared_ptr<Slot> selected;
+            std::size_t least = std::numeric_limits<std::size_t>::max();
+
+            for (std::shared_ptr<Slot>& slot : slots) {
+              if (!slot->isConnected()) {
+                continue;
+              }
+
+              const std::size_t outstanding = slot->getOutstanding();
+              if (outstanding < least) {
+                least = outstanding;
+                selected = slot;
+              }
+            }
+
+            return selected;
+          }
+
+          /// Completes a pending call, that cannot be sent
+          void cancel(const boost::json::value* id) {
+            if (nullptr == id) {
+              return;
+            }
+
+            util::FromJson<TId> id_conv;
+            typename util::FromJson<TId>::conversion_failure converted = id_conv(*id);
+            if (converted) {
+              log_t::Cancel(converted.getSuccess());
+            }
+          }
+
+          /// IO context of the connections
+          boost::asio::io_context& ctx;
+
+          /// Host of the server
+          std::string host;
+
+          /// Port of the server
+          std::uint16_t port;
+
+          /// Connection pool, the slots are shared with the write completions
+          std::vector<std::shared_ptr<Slot>> slots;
+
+          /// Default executor of the responses
+          util::InlineExecutor inlineExecutor;
+
+          /// Executor of the responses
+          util::Executor* executor;
+      };
+    }
+  }
+}
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/bind/bind.hpp>
 #include <boost/shared_ptr.hpp>
@@ -10,13 +16,53 @@
 #include <boost/asio.hpp>
 #include <boost/log/trivial.hpp>
 
+#include "../error/errorcodes.hpp"
+#include "../util/admission_control.hpp"
+#include "../util/executor.hpp"
 #include "../util/jsonstreamer.hpp"
+#include "../util/msgpack.hpp"
 #include "../util/observer.hpp"
 #include "../module.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
     namespace com {
+      /**
+       * @brief Wire format
+       *
+       * Encoding of the messages on a connection. It is detected from the
+       * first received byte and used for all responses of the connection.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      enum class WireFormat {
+        UNKNOWN,
+        JSON,
+        MSGPACK
+      };
+
+      /**
+       * @brief Connection limits
+       *
+       * Backpressure limits of a connection. When a limit is reached, the
+       * connection stops reading until the work drained, so a client that
+       * pipelines faster than the server handles its requests is throttled
+       * by TCP flow control. A limit of zero disables it.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct ConnectionLimits {
+          /// Maximum amount of received messages, that are not handled yet
+          std::size_t max_in_flight = 1024;
+
+          /// Maximum amount of bytes, that wait to be written
+          std::size_t max_queued_bytes = 16 * 1024 * 1024;
+      };
+
       /**
        * @brief TCP connection
        *
@@ -45,6 +91,12 @@ namespace ts7 {
           using data_written_t = util::Observer<id_t, std::string>;
           using data_written_info_t = util::Observer<id_t, const boost::system::error_code&, std::size_t>;
 
+          /// Completion callback of a single write
+          using written_t = std::function<void(const boost::system::error_code&)>;
+
+          /// Maximum amount of messages, that are gathered into one write
+          static constexpr const std::size_t max_gather = 64;
+
 
           /**
            * @brief Create
@@ -52,6 +104,8 @@ namespace ts7 {
            * Creates a TCP connection with the provided IO context.
            *
            * @param io_context Provided IO context.
+           * @param executor Executor, that handles the received messages. The
+           * connection uses the shard of its id, see \ref util::Executor::getShard.
            *
            * @return Retuns a shared pointer to the created TCP connection.
            *
@@ -59,8 +113,8 @@ namespace ts7 {
            *
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
-          inline static Ptr Create(TOwner* owner, boost::asio::io_context& io_context, module_t* procedures) {
-            return Ptr(new TcpConnection(owner, io_context, procedures));
+          inline static Ptr Create(TOwner* owner, boost::asio::io_context& io_context, module_t* procedures, util::Executor* executor) {
+            return Ptr(new TcpConnection(owner, io_context, procedures, executor));
           }
 
           /**
@@ -86,41 +140,197 @@ namespace ts7 {
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
           void waitForRequest() {
-
-            std::memset(msg, 0, sizeof(msg));
             sock.async_read_some(
               boost::asio::buffer(msg, sizeof(msg)),
-              boost::bind(
+              boost::asio::bind_executor(strand, boost::bind(
                 &TcpConnection::handle_read,
                 this->shared_from_this(),
                 boost::asio::placeholders::error,
                 boost::asio::placeholders::bytes_transferred
-              )
+              ))
             );
           }
 
-          void write(const boost::json::value& response) {
+          void write(const boost::json::value& response, written_t written = written_t()) {
             if ( !response.is_null() ) {
-              std::stringstream ss;
-              ss << response;
+              if (WireFormat::MSGPACK == format) {
+                write(util::MsgPack::Encode(response), std::move(written));
+                return;
+              }
 
-              write(ss.str());
+              write(boost::json::serialize(response), std::move(written));
             }
           }
 
-          void write(const std::string& s) {
-            boost::asio::async_write(sock, boost::asio::buffer(s, s.length()), boost::asio::transfer_all(),
-                boost::bind(&TcpConnection::handle_write, this->shared_from_this(),
-                  s,
-                  boost::asio::placeholders::error,
-                  boost::asio::placeholders::bytes_transferred));
+          /**
+           * @brief Write
+           *
+           * Appends \p s to the output queue of the connection and returns
+           * immediately. The queue is only touched by the strand of the
+           * connection, so responses of several threads never interleave.
+           * One write is in flight at a time, it sends everything queued
+           * meanwhile as one gathered write.
+           *
+           * @param s The serialized message.
+           * @param written Called on the strand, once \p s got written.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void write(const std::string& s, written_t written = written_t()) {
+            enqueue(Output{std::make_shared<const std::string>(s), std::move(written)}, false);
+          }
+
+          /// Write, that takes over the serialized message \p s instead of copying it
+          void write(std::string&& s, written_t written = written_t()) {
+            enqueue(Output{std::make_shared<const std::string>(std::move(s)), std::move(written)}, false);
+          }
+
+          /**
+           * @brief Queue
+           *
+           * Sends \p message without reporting its completion. This is meant
+           * for fire and forget messages like notifications, which are
+           * coalesced with everything else in the output queue.
+           *
+           * @param message The message that shall be sent.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline void queue(const boost::json::value& message) {
+            write(message);
+          }
+
+          /**
+           * @brief Stream write
+           *
+           * Writes a streamed response chunk by chunk and returns immediately.
+           * The next chunk is only produced by the executor after the previous
+           * one got written, so the memory stays bounded to one chunk and a
+           * slow reader throttles the producer without occupying a worker
+           * while its data is in flight.
+           *
+           * @note Other responses of this connection are held back until the
+           * stream is finished. Streams of the same connection are written
+           * one after the other. If the stream fails, the connection is
+           * closed.
+           *
+           * @param stream The stream that shall be written.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void write(ResultStream stream) {
+            Ptr self = this->shared_from_this();
+            std::shared_ptr<ResultStream> s = std::make_shared<ResultStream>(std::move(stream));
+
+            boost::asio::post(strand, [self, s]() {
+              if (self->streaming) {
+                self->streams.push_back(s);
+                return;
+              }
+
+              self->streaming = true;
+              self->produce(s);
+            });
           }
 
           inline id_t getID() const {
             return id;
           }
 
+          /**
+           * @brief Wire format
+           *
+           * @return Returns the wire format detected for this connection.
+           * Returns \p WireFormat::UNKNOWN until the first data got received.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline WireFormat getWireFormat() const {
+            return format;
+          }
+
+          /**
+           * @brief Set limits
+           *
+           * Sets the backpressure limits of the connection.
+           *
+           * @note Needs to be called before \ref waitForRequest.
+           *
+           * @param limits The limits of the connection.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline void setLimits(const ConnectionLimits& limits) {
+            this->limits = limits;
+          }
+
+          inline const ConnectionLimits& getLimits() const {
+            return limits;
+          }
+
+          /**
+           * @brief Set admission control
+           *
+           * Sets the admission control, that rejects requests while the
+           * server is overloaded. Null admits all requests.
+           *
+           * @note Needs to be called before \ref waitForRequest.
+           *
+           * @param admission The admission control of the server.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline void setAdmissionControl(util::AdmissionControl* admission) {
+            this->admission = admission;
+          }
+
+          /// Returns the amount of received messages, that are not handled yet
+          inline std::size_t getInFlight() const {
+            return inFlight.load(std::memory_order_relaxed);
+          }
+
         protected:
+          /// Queued message with its completion
+          struct Output {
+              std::shared_ptr<const std::string> data;
+              written_t written;
+          };
+
+          /// Received batch and its responses
+          struct Batch {
+              inline explicit Batch(boost::json::array requests)
+                : requests(std::move(requests)),
+                  responses(this->requests.size()),
+                  remaining(this->requests.size())
+              {}
+
+              boost::json::array requests;
+              std::vector<boost::json::value> responses;
+              std::atomic<std::size_t> remaining;
+          };
+
+          /// Counts dispatched messages until they are handled
+          struct InFlight {
+              Ptr conn;
+              std::size_t count;
+
+              inline ~InFlight() {
+                conn->completed(count);
+              }
+          };
+
           /**
            * @brief constructor
            *
@@ -132,11 +342,13 @@ namespace ts7 {
            *
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
-          inline TcpConnection(TOwner* owner, boost::asio::io_context& ctx, ts7::jsonrpc::Module<TId>* procedures)
+          inline TcpConnection(TOwner* owner, boost::asio::io_context& ctx, ts7::jsonrpc::Module<TId>* procedures, util::Executor* executor)
             : owner(owner),
-              id(++nextID),
+              id(nextID.fetch_add(1, std::memory_order_relaxed) + 1),
               sock(ctx),
-              procedures(procedures)
+              strand(boost::asio::make_strand(sock.get_executor())),
+              procedures(procedures),
+              executor(executor->getShard(id))
           {}
 
           /**
@@ -157,50 +369,38 @@ namespace ts7 {
             data_received_info.notify(getID(), error, bytes_transferred);
 
             if (!error && bytes_transferred > 0) {
-              BOOST_LOG_TRIVIAL(debug) << "[Client " << getID() << "] <- " << msg << std::endl;
-              data_received.notify(getID(), std::string(msg));
-
-              streamer += msg;
-              boost::json::value v;
-              do {
-                v = streamer.getNextChunk();
-
-                if (v.is_object()) {
-                  const boost::json::object& o = v.as_object();
-                  std::future<void> f = std::async(std::launch::async, [this, o]() -> void {
-                    if ( o.contains("params") ) {
-                      // Seems to be a request/notification
-                      handleRequest(o);
-                    }
-                    else if ( o.contains("result") ) {
-                      // Seesms to be a response
-                      handleResponse(o);
-                    }
-                    else if ( o.contains("error") ) {
-                      // Seems to be an error
-                      handleError(o);
-                    }
-                    else {
-                      BOOST_LOG_TRIVIAL(error) << "Unknown message type: " << o;
-                    }
-                  });
-
-                  owner->addCallFuture(std::move(f));
-                }
-                else if (v.is_array()) {
-                  const boost::json::array& a = v.as_array();
-                  std::future<void> f = std::async(std::launch::async, [this, a]() -> void {
-                    handleBatch(a);
-                  });
+              // Binary formats may contain NUL bytes, use the transferred size
+              const std::string data(msg, bytes_transferred);
+
+              if (WireFormat::UNKNOWN == format) {
+                format = util::MsgPack::IsMsgPack(data.front()) ? WireFormat::MSGPACK : WireFormat::JSON;
+              }
 
-                  owner->addCallFuture(std::move(f));
+              if (WireFormat::JSON == format) {
+                BOOST_LOG_TRIVIAL(debug) << "[Client " << getID() << "] <- " << data << std::endl;
+              }
+              else {
+                BOOST_LOG_TRIVIAL(debug) << "[Client " << getID() << "] <- " << bytes_transferred << " bytes MessagePack";
+              }
+              data_received.notify(getID(), data);
+
+              try {
+                if (WireFormat::MSGPACK == format) {
+                  packStreamer += data;
                 }
-              } while ( !v.is_null() );
+                else {
+                  streamer += data;
+                }
+              }
+              catch (const std::exception& e) {
+                BOOST_LOG_TRIVIAL(error) << "Invalid message from client " << getID() << ": " << e.what();
+              }
 
-              waitForRequest();
+              readNext();
             }
             else if (error) {
-              if (error.value() == boost::system::errc::no_such_file_or_directory || error.value() == boost::system::errc::connection_reset) {
+              if (error.value() == boost::system::errc::no_such_file_or_directory || error.value() == boost::system::errc::connection_reset
+                  || error == boost::asio::error::operation_aborted || error == boost::asio::error::bad_descriptor) {
                 BOOST_LOG_TRIVIAL(info) << "Client " << getID() << " connection closed by partner";
                 connection_closed.notify(getID());
                 return;
@@ -211,60 +411,468 @@ namespace ts7 {
             }
           }
 
+          /**
+           * @brief Enqueue
+           *
+           * Appends \p output to the output queue on the strand.
+           *
+           * @param output The serialized message and its completion.
+           * @param stream The output is a chunk of the current stream.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void enqueue(Output output, bool stream) {
+            if (strand.running_in_this_thread()) {
+              // Inline procedures answer on the strand
+              append(std::move(output), stream);
+              return;
+            }
+
+            Ptr self = this->shared_from_this();
+            boost::asio::post(strand, [self, output = std::move(output), stream]() mutable {
+              self->append(std::move(output), stream);
+            });
+          }
+
+          /// Produces and writes the next chunk of \p stream on the executor, runs on the strand
+          void produce(std::shared_ptr<ResultStream> stream) {
+            Ptr self = this->shared_from_this();
+            executor->execute([self, stream]() {
+              std::string chunk;
+              if (!stream->next(chunk)) {
+                boost::asio::post(self->strand, [self, stream]() {
+                  self->finish(stream->hasFailed());
+                });
+                return;
+              }
+
+              self->enqueue(Output{
+                std::make_shared<const std::string>(std::move(chunk)),
+                [self, stream](const boost::system::error_code& error) {
+                  if (error) {
+                    BOOST_LOG_TRIVIAL(error) << "Stream write failed for client " << self->getID() << ": " << error.message();
+                    self->finish(false);
+                    return;
+                  }
+
+                  // Pull the next chunk once this one is written
+                  self->produce(stream);
+                }
+              }, true);
+            });
+          }
+
+          /// Ends the current stream and starts the next one, runs on the strand
+          void finish(bool failed) {
+            if (failed) {
+              // The response is incomplete, the client only notices a closed connection
+              abort();
+            }
+
+            // Release the held back responses
+            std::move(held.begin(), held.end(), std::back_inserter(pending));
+            held.clear();
+
+            if (streams.empty()) {
+              streaming = false;
+            }
+            else {
+              produce(streams.front());
+              streams.pop_front();
+            }
+
+            flush();
+          }
+
+          /// Closes the socket, runs on the strand
+          void abort() {
+            BOOST_LOG_TRIVIAL(error) << "Closing client " << getID() << " after an incomplete response";
+
+            boost::system::error_code ignored;
+            sock.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+            sock.close(ignored);
+          }
+
+          /// Appends \p output to the output queue, runs on the strand
+          void append(Output output, bool stream) {
+            queuedBytes += output.data->size();
+            if (streaming && !stream) {
+              held.push_back(std::move(output));
+              return;
+            }
+
+            pending.push_back(std::move(output));
+            flush();
+          }
+
+          /// Starts a gathered write of the queued output, runs on the strand
+          void flush() {
+            if (writing || pending.empty()) {
+              return;
+            }
+
+            writing = true;
+            const std::size_t count = std::min(pending.size(), max_gather);
+            for (std::size_t i = 0; i < count; ++i) {
+              inflight.push_back(std::move(pending.front()));
+              pending.pop_front();
+              buffers.push_back(boost::asio::buffer(*inflight.back().data));
+            }
+
+            boost::asio::async_write(sock, buffers, boost::asio::transfer_all(),
+                boost::asio::bind_executor(strand, boost::bind(&TcpConnection::handle_write, this->shared_from_this(),
+                  boost::asio::placeholders::error,
+                  boost::asio::placeholders::bytes_transferred)));
+          }
+
           /**
            * @brief write callback
            *
-           * Callback, that is executed when data got written to the socket.
+           * Callback, that is executed on the strand when the gathered output
+           * got written to the socket. It completes the written messages and
+           * starts the next write.
            *
            * @param error Error code, if an error occured while transferring the data.
            * @param bytes_transferred Amount of bytes transferred.
            *
-           * @note This function will call \p echo to restart the echoing process.
-           *
            * @since 1.0
            *
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
-          void handle_write(std::string data, const boost::system::error_code& error, size_t bytes_transferred) {
+          void handle_write(const boost::system::error_code& error, size_t bytes_transferred) {
             data_written_info.notify(getID(), error, bytes_transferred);
 
-            if (!error && bytes_transferred > 0) {
-              BOOST_LOG_TRIVIAL(debug) << "[Client " << getID() << "] -> " << data;
-              data_written.notify(getID(), data);
+            if (error) {
+              BOOST_LOG_TRIVIAL(error) << "Write failed for client " << getID() << ": " << error.message();
+            }
+
+            for (Output& output : inflight) {
+              queuedBytes -= output.data->size();
+              if (!error) {
+                BOOST_LOG_TRIVIAL(debug) << "[Client " << getID() << "] -> " << *output.data;
+                data_written.notify(getID(), *output.data);
+              }
+
+              if (output.written) {
+                output.written(error);
+              }
             }
+
+            inflight.clear();
+            buffers.clear();
+            writing = false;
+            flush();
+            resume();
           }
 
-          void handleBatch(const boost::json::array& a) {
-            BOOST_LOG_TRIVIAL(debug) << "Handling batch job";
-            for (boost::json::array::const_iterator it = a.begin(); it != a.end(); ++it) {
-              boost::json::value sv = *it;
-              if (sv.is_object()) {
-                const boost::json::object& o = sv.as_object();
-                if ( o.contains("params") ) {
-                  // Seems to be a request/notification
-                  handleRequest(o);
+          /**
+           * @brief Read next
+           *
+           * Dispatches the buffered messages and continues reading, both
+           * only until a limit of the connection is reached. The remaining
+           * messages stay in the streamer. A paused connection is resumed by
+           * \ref resume, once the handled messages or the written output
+           * brought it below its limits. Runs on the strand.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void readNext() {
+            try {
+              while (!isOverloaded()) {
+                boost::json::value v = (WireFormat::MSGPACK == format) ? packStreamer.getNextChunk() : streamer.getNextChunk();
+                if (v.is_null()) {
+                  break;
                 }
-                else if ( o.contains("result") ) {
-                  // Seesms to be a response
-                  handleResponse(o);
+
+                dispatch(std::move(v));
+              }
+            }
+            catch (const std::exception& e) {
+              BOOST_LOG_TRIVIAL(error) << "Invalid message from client " << getID() << ": " << e.what();
+            }
+
+            if (isOverloaded()) {
+              BOOST_LOG_TRIVIAL(debug) << "Client " << getID() << " paused reading, " << getInFlight() << " messages in flight, " << queuedBytes << " bytes queued";
+              paused = true;
+              return;
+            }
+
+            waitForRequest();
+          }
+
+          /// Resumes a paused connection below its limits, runs on the strand
+          void resume() {
+            if (paused && !isOverloaded()) {
+              BOOST_LOG_TRIVIAL(debug) << "Client " << getID() << " resumed reading";
+              paused = false;
+              readNext();
+            }
+          }
+
+          /// Returns whether a limit is reached, runs on the strand
+          inline bool isOverloaded() const {
+            return (limits.max_in_flight > 0 && inFlight.load(std::memory_order_acquire) >= limits.max_in_flight)
+                || (limits.max_queued_bytes > 0 && queuedBytes >= limits.max_queued_bytes);
+          }
+
+          /// Marks \p count dispatched messages as handled
+          void completed(std::size_t count) {
+            const std::size_t previous = inFlight.fetch_sub(count, std::memory_order_acq_rel);
+
+            // Resume once half of the limit drained, not after every message
+            const std::size_t low = limits.max_in_flight / 2;
+            if (limits.max_in_flight > 0 && previous > low && previous - count <= low) {
+              Ptr self = this->shared_from_this();
+              boost::asio::post(strand, [self]() {
+                self->resume();
+              });
+            }
+          }
+
+          /**
+           * @brief dispatch
+           *
+           * Dispatches one received message, independent of its wire format.
+           * The message is handled by the executor of the connection. Inline
+           * procedures run directly on the strand, their response is
+           * appended to the output queue without a thread hand over.
+           *
+           * @param v The received message, it is moved into the task of the
+           * executor. Null values are ignored.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void dispatch(boost::json::value&& v) {
+            Ptr self = this->shared_from_this();
+
+            if (v.is_object()) {
+              const typename module_t::Scheduling scheduling = getScheduling(v);
+              if (scheduling.run_inline) {
+                handleMessage(v.as_object());
+                return;
+              }
+
+              // Latency critical requests are short, they are neither measured nor rejected
+              const bool controlled = (nullptr != admission) && (util::SchedulingClass::LATENCY_CRITICAL != scheduling.cls);
+              if (controlled && !admit(v)) {
+                return;
+              }
+
+              inFlight.fetch_add(1, std::memory_order_relaxed);
+              executor->execute([self, o = std::make_shared<const boost::json::object>(std::move(v.as_object())), queued = Queued(controlled)]() -> void {
+                InFlight guard{self, 1};
+                self->started(queued);
+                self->handleMessage(*o, o);
+              }, scheduling.cls);
+            }
+            else if (v.is_array()) {
+              if (nullptr != admission && !admit(v)) {
+                return;
+              }
+
+              // Every element of a batch counts, until it got handled
+              inFlight.fetch_add(v.as_array().size(), std::memory_order_relaxed);
+              executor->execute([self, a = std::move(v.as_array()), queued = Queued(nullptr != admission)]() mutable -> void {
+                self->started(queued);
+                self->handleBatch(std::move(a));
+              });
+            }
+          }
+
+          /**
+           * @brief Admit
+           *
+           * Asks the admission control, whether the message \p v shall be
+           * queued. While the server is overloaded, every request is
+           * answered with a server busy error and notifications are dropped.
+           * A batch is rejected as a whole.
+           *
+           * @param v The received request, notification or batch.
+           *
+           * @return Returns true, if \p v shall be handled.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          bool admit(const boost::json::value& v) {
+            if (nullptr == procedures || admission->admit()) {
+              return true;
+            }
+
+            if (v.is_object()) {
+              if (!v.as_object().contains("method")) {
+                // Responses are never rejected
+                return true;
+              }
+
+              write(procedures->reject(v.as_object(), error::ServerBusy()));
+              return false;
+            }
+
+            boost::json::array responses;
+            for (const boost::json::value& element : v.as_array()) {
+              if (element.is_object() && element.as_object().contains("method")) {
+                boost::json::value response = procedures->reject(element.as_object(), error::ServerBusy());
+                if (!response.is_null()) {
+                  responses.push_back(std::move(response));
                 }
-                else if ( o.contains("error") ) {
-                  // Seems to be an error
-                  handleError(o);
+              }
+            }
+
+            if (!responses.empty()) {
+              write(boost::json::value(std::move(responses)));
+            }
+
+            return false;
+          }
+
+          /// Returns the queue time of a task, if its delay is measured
+          inline util::AdmissionControl::clock_t::time_point Queued(bool measured) {
+            return measured ? admission->enqueue() : util::AdmissionControl::clock_t::time_point();
+          }
+
+          /// Reports the queueing delay of a task, that was queued at \p queued
+          inline void started(util::AdmissionControl::clock_t::time_point queued) {
+            if (util::AdmissionControl::clock_t::time_point() != queued) {
+              admission->record(queued);
+            }
+          }
+
+          /// Returns the scheduling of the procedure, that \p v calls
+          inline typename module_t::Scheduling getScheduling(const boost::json::value& v) const {
+            if (nullptr == procedures || !v.is_object()) {
+              return typename module_t::Scheduling();
+            }
+
+            return procedures->getScheduling(v.as_object());
+          }
+
+          /// Handles a single request, notification, response or error, \p request keeps \p o alive for streamed responses
+          void handleMessage(const boost::json::object& o, std::shared_ptr<const void> request = nullptr) {
+            if ( o.contains("params") ) {
+              // Seems to be a request/notification
+              handleRequest(o, std::move(request));
+            }
+            else if ( o.contains("result") ) {
+              // Seesms to be a response
+              handleResponse(o);
+            }
+            else if ( o.contains("error") ) {
+              // Seems to be an error
+              handleError(o);
+            }
+            else {
+              BOOST_LOG_TRIVIAL(error) << "Unknown message type: " << o;
+            }
+          }
+
+          /**
+           * @brief Handle batch
+           *
+           * Handles the elements of a batch concurrently on the executor.
+           * Inline elements and the last element are handled in the calling
+           * thread. The element, that finishes last, answers with one array
+           * of all responses in a single write. Notifications have no
+           * response, a batch without responses is not answered.
+           *
+           * @param a The received batch.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void handleBatch(boost::json::array a) {
+            BOOST_LOG_TRIVIAL(debug) << "Handling batch job of " << a.size() << " elements";
+            if (a.empty()) {
+              return;
+            }
+
+            std::shared_ptr<Batch> batch = std::make_shared<Batch>(std::move(a));
+            Ptr self = this->shared_from_this();
+
+            const std::size_t last = batch->requests.size() - 1;
+            for (std::size_t i = 0; i < last; ++i) {
+              const typename module_t::Scheduling scheduling = getScheduling(batch->requests[i]);
+              if (scheduling.run_inline) {
+                handleBatchElement(*batch, i);
+                continue;
+              }
+
+              executor->execute([self, batch, i]() -> void {
+                self->handleBatchElement(*batch, i);
+              }, scheduling.cls);
+            }
+
+            handleBatchElement(*batch, last);
+          }
+
+          /// Handles the element \p index of \p batch and answers the batch after its last element
+          void handleBatchElement(Batch& batch, std::size_t index) {
+            {
+              InFlight guard{this->shared_from_this(), 1};
+              const boost::json::value& element = batch.requests[index];
+
+              try {
+                if (element.is_object() && element.as_object().contains("params")) {
+                  if (procedures) {
+                    owner->registerCall(this->shared_from_this());
+                    batch.responses[index] = (*procedures)(element.as_object());
+                    owner->releaseCall();
+                  }
                 }
-                else {
-                  BOOST_LOG_TRIVIAL(error) << "Unknown message type: " << o;
+                else if (element.is_object()) {
+                  handleMessage(element.as_object());
                 }
               }
+              catch (const std::exception& e) {
+                BOOST_LOG_TRIVIAL(error) << "Batch element of client " << getID() << " failed: " << e.what();
+              }
+            }
+
+            if (1 != batch.remaining.fetch_sub(1, std::memory_order_acq_rel)) {
+              return;
+            }
+
+            boost::json::array responses;
+            responses.reserve(batch.responses.size());
+            for (boost::json::value& response : batch.responses) {
+              if (!response.is_null()) {
+                responses.push_back(std::move(response));
+              }
+            }
+
+            if (!responses.empty()) {
+              write(boost::json::value(std::move(responses)));
             }
           }
 
-          void handleRequest(const boost::json::object& o) {
+          void handleRequest(const boost::json::object& o, std::shared_ptr<const void> request) {
             if (procedures) {
               owner->registerCall(this->shared_from_this());
 
-              boost::json::value response = (*procedures)(o);
-              write(response);
+              if (WireFormat::MSGPACK == format) {
+                // Binary responses are encoded as a whole
+                write((*procedures)(o));
+              }
+              else {
+                ResultStream stream;
+                boost::json::value response = (*procedures)(o, stream);
+                if (!stream.empty()) {
+                  // The rows are written after this call, they may still view into the request
+                  stream.keep(std::move(request));
+                  write(std::move(stream));
+                }
+                else {
+                  write(response);
+                }
+              }
 
               owner->releaseCall();
             }
@@ -286,8 +894,8 @@ namespace ts7 {
           data_written_info_t data_written_info;
 
         protected:
-          /// Next ID counter
-          static id_t nextID;
+          /// Next ID counter, connections are created by several IO threads
+          static std::atomic<id_t> nextID;
 
           /// Owner
           TOwner* owner;
@@ -304,12 +912,60 @@ namespace ts7 {
           /// JSON streamer
           ts7::jsonrpc::util::JsonStreamer streamer;
 
+          /// MessagePack streamer
+          ts7::jsonrpc::util::MsgPackStreamer packStreamer;
+
+          /// Detected wire format, read by the writing threads
+          std::atomic<WireFormat> format{WireFormat::UNKNOWN};
+
+          /// Strand of the socket, guards the output queue
+          boost::asio::strand<boost::asio::ip::tcp::socket::executor_type> strand;
+
+          /// Output queue
+          std::deque<Output> pending;
+
+          /// Output held back while a stream is written
+          std::deque<Output> held;
+
+          /// Output of the current write
+          std::vector<Output> inflight;
+
+          /// Buffers of the current write
+          std::vector<boost::asio::const_buffer> buffers;
+
+          /// A write is in flight
+          bool writing = false;
+
+          /// A stream is written
+          bool streaming = false;
+
+          /// Streams waiting for the current stream
+          std::deque<std::shared_ptr<ResultStream>> streams;
+
+          /// Backpressure limits
+          ConnectionLimits limits;
+
+          /// Admission control of the server, null admits everything
+          util::AdmissionControl* admission = nullptr;
+
+          /// Amount of received messages, that are not handled yet
+          std::atomic<std::size_t> inFlight{0};
+
+          /// Amount of bytes in the output queue, guarded by the strand
+          std::size_t queuedBytes = 0;
+
+          /// Reading is paused by a limit, guarded by the strand
+          bool paused = false;
+
           /// Server RPC module
           module_t* procedures;
+
+          /// Executor of the received messages, the shard of this connection
+          util::Executor* executor;
       };
 
       template <typename TId, typename TOwner>
-      typename TcpConnection<TId, TOwner>::id_t TcpConnection<TId, TOwner>::nextID = 0;
+      std::atomic<typename TcpConnection<TId, TOwner>::id_t> TcpConnection<TId, TOwner>::nextID{0};
     }
   }
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include <boost/bind/bind.hpp>
@@ -11,13 +14,58 @@
 #include <boost/log/trivial.hpp>
 
 #include "../module.hpp"
+#include "../util/admission_control.hpp"
 #include "../util/observer.hpp"
+#include "../util/thread_pool.hpp"
 
+#include "io_context_pool.hpp"
 #include "tcpconnection.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
     namespace com {
+      /**
+       * @brief Server options
+       *
+       * Listening and socket options of a \ref TcpServer. Buffer sizes of
+       * zero keep the defaults of the system.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct ServerOptions {
+          /// Disables Nagle's algorithm on accepted connections
+          bool no_delay = true;
+
+          /**
+           * Receive buffer size of accepted connections (SO_RCVBUF)
+           *
+           * @note It is set on the acceptor before listening and inherited by
+           * the accepted connections. Set later, it could not influence the
+           * window scaling, that is negotiated during the handshake.
+           */
+          int receive_buffer = 0;
+
+          /// Send buffer size of accepted connections (SO_SNDBUF), inherited from the acceptor too
+          int send_buffer = 0;
+
+          /// Length of the queue of connections, that were not accepted yet
+          int backlog = boost::asio::socket_base::max_listen_connections;
+
+          /// Amount of accepts, that are pending at the same time
+          std::size_t pending_accepts = 1;
+
+          /// Binds to IPv6, which accepts IPv4 clients too, unless \p v6_only is set
+          bool ipv6 = false;
+
+          /// Accepts only IPv6 clients, if bound to IPv6
+          bool v6_only = false;
+
+          /// Delay of the next accept, after accepting failed for lack of file descriptors or memory
+          std::chrono::milliseconds accept_backoff = std::chrono::milliseconds(100);
+      };
+
       /**
        * @brief TCP server
        *
@@ -42,48 +90,184 @@ namespace ts7 {
            * Creates a TCP server by a provided IO context.
            *
            * @param ctx IO context that shall be used by the server.
+           * @param executor Executor of the received messages. Without an
+           * executor the server uses an own \ref util::ThreadPool with one
+           * worker per core. A \ref util::ShardedExecutor handles the
+           * messages of every connection in order on one worker.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline TcpServer(TOwner* owner, boost::asio::io_context& ctx, uint16_t port = 9200, util::Executor* executor = nullptr)
+            : TcpServer(owner, ctx, port, ServerOptions(), executor)
+          {}
+
+          /**
+           * @brief constructor
+           *
+           * Creates a TCP server with the provided listening and socket
+           * options.
+           *
+           * @param ctx IO context that shall be used by the server.
+           * @param options Listening and socket options.
+           * @param executor Executor of the received messages.
+           *
+           * @throws boost::system::system_error, if binding or listening failed.
            *
            * @since 1.0
            *
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
-          inline TcpServer(TOwner* owner, boost::asio::io_context& ctx, uint16_t port = 9200)
+          inline TcpServer(TOwner* owner, boost::asio::io_context& ctx, uint16_t port, const ServerOptions& options, util::Executor* executor = nullptr)
             : owner(owner),
               ctx(ctx),
-              acceptor(ctx, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port))
+              options(options),
+              acceptor(boost::asio::make_strand(ctx)),
+              backoff(acceptor.get_executor()),
+              pool(executor ? nullptr : new util::ThreadPool()),
+              executor(executor ? executor : pool.get())
           {
+            const boost::asio::ip::tcp::endpoint endpoint(options.ipv6 ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), port);
+
+            acceptor.open(endpoint.protocol());
+            acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            if (options.ipv6) {
+              acceptor.set_option(boost::asio::ip::v6_only(options.v6_only));
+            }
+
+            // Accepted connections inherit the buffer sizes of the listening socket
+            if (options.receive_buffer > 0) {
+              setOption(acceptor, boost::asio::socket_base::receive_buffer_size(options.receive_buffer), "receive buffer size");
+            }
+
+            if (options.send_buffer > 0) {
+              setOption(acceptor, boost::asio::socket_base::send_buffer_size(options.send_buffer), "send buffer size");
+            }
+
+            acceptor.bind(endpoint);
+            acceptor.listen(options.backlog);
+
             BOOST_LOG_TRIVIAL(info) << "Listening on port " << port;
             server_started.notify(port);
           }
 
+          /**
+           * @brief constructor
+           *
+           * Creates a TCP server, that spreads its connections round robin
+           * over the IO contexts of \p contexts. The acceptor runs on the
+           * first IO context, every connection then does its socket I/O on
+           * the thread of its own IO context.
+           *
+           * @param contexts IO contexts of the connections.
+           * @param executor Executor of the received messages.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline TcpServer(TOwner* owner, IoContextPool& contexts, uint16_t port = 9200, util::Executor* executor = nullptr)
+            : TcpServer(owner, contexts, port, ServerOptions(), executor)
+          {}
+
+          /// Spreads the connections over \p contexts, see above, with the provided options
+          inline TcpServer(TOwner* owner, IoContextPool& contexts, uint16_t port, const ServerOptions& options, util::Executor* executor = nullptr)
+            : TcpServer(owner, contexts.get(0), port, options, executor)
+          {
+            this->contexts = &contexts;
+          }
+
           /**
            * @brief Start accept
            *
-           * Starts accepting clients on the TCP server.
+           * Starts accepting clients on the TCP server. The configured amount
+           * of accepts is kept pending, so a burst of clients is accepted
+           * without a round trip through the IO context per client.
            *
            * @since 1.0
            *
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
           inline void startAccept() {
-            BOOST_LOG_TRIVIAL(info) << "Waiting for new client";
+            BOOST_LOG_TRIVIAL(info) << "Waiting for new clients";
 
-            typename TcpConnection<TId, TOwner>::Ptr new_conn = TcpConnection<TId, TOwner>::Create(owner, ctx, &procedures);
+            // The acceptor is only used on its strand
+            boost::asio::post(acceptor.get_executor(), [this]() {
+              for (std::size_t i = 0; i < std::max<std::size_t>(options.pending_accepts, 1); ++i) {
+                accept();
+              }
+            });
+          }
 
-            acceptor.async_accept(
-                  new_conn->socket(),
-                  boost::bind(&TcpServer::handle_accept, this, new_conn, boost::asio::placeholders::error)
-            );
+          inline const ServerOptions& getOptions() const {
+            return options;
+          }
+
+          /**
+           * @brief Set connection limits
+           *
+           * Sets the backpressure limits of the connections, that are
+           * accepted from now on.
+           *
+           * @param limits The limits of every connection.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline void setConnectionLimits(const ConnectionLimits& limits) {
+            this->limits = limits;
+          }
+
+          inline const ConnectionLimits& getConnectionLimits() const {
+            return limits;
+          }
+
+          template <typename T>
+          inline void registerRequest(const std::string& name, const T& t, util::SchedulingClass cls = util::SchedulingClass::NORMAL, bool run_inline = false) {
+            procedures.addRequest(name, t, cls, run_inline);
           }
 
           template <typename T>
-          inline void registerRequest(const std::string& name, const T& t) {
-            procedures.addRequest(name, t);
+          inline void registerStreamingRequest(const std::string& name, const T& t, util::SchedulingClass cls = util::SchedulingClass::NORMAL) {
+            procedures.addStreamingRequest(name, t, cls);
           }
 
           template <typename T>
-          inline void registerNotification(const std::string& name, const T& t) {
-            procedures.addNotification(name, t);
+          inline void registerNotification(const std::string& name, const T& t, util::SchedulingClass cls = util::SchedulingClass::NORMAL, bool run_inline = false) {
+            procedures.addNotification(name, t, cls, run_inline);
+          }
+
+          /**
+           * @brief Enable admission control
+           *
+           * Enables the load shedding of the connections. Requests are
+           * rejected with a server busy error, while their queueing delay
+           * stays above \p target for \p interval, see
+           * \ref util::AdmissionControl.
+           *
+           * @note Needs to be called before \ref startAccept.
+           *
+           * @param target Acceptable queueing delay.
+           * @param interval Time the delay needs to stay above \p target.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline void enableAdmissionControl(std::chrono::nanoseconds target = std::chrono::milliseconds(5), std::chrono::nanoseconds interval = std::chrono::milliseconds(100)) {
+            admission.reset(new util::AdmissionControl(target, interval));
+          }
+
+          /// Returns the admission control, null if it is not enabled
+          inline const util::AdmissionControl* getAdmissionControl() const {
+            return admission.get();
+          }
+
+          /// Returns the own thread pool, null if the server uses a provided executor
+          inline const util::ThreadPool* getThreadPool() const {
+            return pool.get();
           }
 
           template <typename T>
@@ -105,13 +289,82 @@ namespace ts7 {
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
           inline void handle_accept(typename TcpConnection<TId, TOwner>::Ptr conn, const boost::system::error_code& error) {
+            if (error == boost::asio::error::operation_aborted || !acceptor.is_open()) {
+              // The server is shutting down
+              return;
+            }
+
             if (!error) {
-              BOOST_LOG_TRIVIAL(info) << "Accepted new client";
+              BOOST_LOG_TRIVIAL(debug) << "Accepted client " << conn->getID();
+              configure(conn->socket());
               new_client_accepted.notify(conn);
+              conn->setLimits(limits);
+              conn->setAdmissionControl(admission.get());
               conn->waitForRequest();
             }
+            else if (IsExhausted(error)) {
+              // Accepting again right away would fail again, retry all failed accepts after the backoff
+              if (0 == deferred++) {
+                BOOST_LOG_TRIVIAL(error) << "Accept failed: " << error.message() << ", retrying in " << options.accept_backoff.count() << " ms";
+                backoff.expires_after(options.accept_backoff);
+                backoff.async_wait(boost::bind(&TcpServer::handle_backoff, this, boost::asio::placeholders::error));
+              }
+
+              return;
+            }
+            else {
+              BOOST_LOG_TRIVIAL(error) << "Accept failed: " << error.message();
+            }
+
+            accept();
+          }
+
+          /// Restarts the accepts, that failed during the backoff, runs on the strand of the acceptor
+          void handle_backoff(const boost::system::error_code& error) {
+            if (error == boost::asio::error::operation_aborted || !acceptor.is_open()) {
+              return;
+            }
+
+            const std::size_t count = deferred;
+            deferred = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+              accept();
+            }
+          }
+
+          /// Returns true, if accepting failed for lack of file descriptors or memory
+          static inline bool IsExhausted(const boost::system::error_code& error) {
+            return error == boost::asio::error::no_descriptors
+                || error == boost::system::errc::too_many_files_open_in_system
+                || error == boost::asio::error::no_buffer_space
+                || error == boost::asio::error::no_memory;
+          }
+
+          /// Starts one accept, runs on the strand of the acceptor
+          void accept() {
+            typename TcpConnection<TId, TOwner>::Ptr new_conn = TcpConnection<TId, TOwner>::Create(owner, contexts ? contexts->next() : ctx, &procedures, executor);
+
+            acceptor.async_accept(
+                  new_conn->socket(),
+                  boost::bind(&TcpServer::handle_accept, this, new_conn, boost::asio::placeholders::error)
+            );
+          }
+
+          /// Applies the socket options, that are not inherited from the acceptor, to an accepted connection
+          void configure(boost::asio::ip::tcp::socket& sock) {
+            if (options.no_delay) {
+              setOption(sock, boost::asio::ip::tcp::no_delay(true), "no delay");
+            }
+          }
 
-            startAccept();
+          /// Sets a single socket option and logs, if it could not be set
+          template <typename TSocket, typename TOption>
+          static void setOption(TSocket& sock, const TOption& option, const char* name) {
+            boost::system::error_code error;
+            sock.set_option(option, error);
+            if (error) {
+              BOOST_LOG_TRIVIAL(warning) << "Could not set the socket option " << name << ": " << error.message();
+            }
           }
 
         public:
@@ -126,11 +379,35 @@ namespace ts7 {
           /// IO context of the server
           boost::asio::io_context& ctx;
 
+          /// IO contexts of the connections, if they are spread
+          IoContextPool* contexts = nullptr;
+
+          /// Listening and socket options
+          ServerOptions options;
+
           /// Acceptor for new connections
           boost::asio::ip::tcp::acceptor acceptor;
 
+          /// Delays the failed accepts on the strand of the acceptor
+          boost::asio::steady_timer backoff;
+
+          /// Amount of accepts, that wait for the backoff
+          std::size_t deferred = 0;
+
           /// List of registered procedures
           module_t procedures;
+
+          /// Backpressure limits of the connections
+          ConnectionLimits limits;
+
+          /// Load shedding of the connections, null if it is disabled
+          std::unique_ptr<util::AdmissionControl> admission;
+
+          /// Own executor, destroyed first so running requests finish while the procedures and the admission control exist
+          std::unique_ptr<util::ThreadPool> pool;
+
+          /// Executor of the received messages
+          util::Executor* executor;
       };
     }
   }
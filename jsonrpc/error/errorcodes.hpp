@@ -111,6 +111,21 @@ namespace ts7 {
 
         /// This procedure needs to be implemented
         NOT_YET_IMPLEMENTED,
+
+        /// No response was received before the deadline of the call
+        CALL_TIMEOUT,
+
+        /// The call got cancelled before a response was received
+        CALL_CANCELLED,
+
+        /// Field data within error has the wrong type
+        ERROR_DATA_WRONG_TYPE,
+
+        /// The server is overloaded and rejected the request
+        SERVER_BUSY,
+
+        /// A call with the same id is already pending
+        CALL_ID_PENDING,
       };
 
       /// Conversion from ErrorCode to std::int32_t
@@ -724,6 +739,86 @@ namespace ts7 {
         return ErrorCode::WrongParameterType(Code(ErrorCodes::PARAMETER_WRONG_TYPE), name, actual, expected);
       }
 
+      /**
+       * @brief Parameter element wrong type
+       *
+       * Factory method to create an \p ErrorCode, if an element of an array
+       * parameter has an unexpected data type.
+       *
+       * @param name The name of the parameter.
+       * @param index The index of the failing element.
+       * @param actual The actual data type of the element.
+       * @param expected The expected data type of the element.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode ParameterElementWrongType(const std::string& name, std::size_t index, util::JsonType actual, util::JsonType expected) {
+        return ErrorCode(
+          Code(ErrorCodes::PARAMETER_WRONG_TYPE),
+          (boost::format("Element %1% of parameter \"%2%\" is of type \"%3%\", expected \"%4%\"") % index % name % GetJsonTypeName(actual) % GetJsonTypeName(expected)).str(),
+          "name", name,
+          "index", index,
+          "actual", GetJsonTypeName(actual),
+          "expected", GetJsonTypeName(expected)
+        );
+      }
+
+      /**
+       * @brief Parameter member missing
+       *
+       * Factory method to create an \p ErrorCode, if a member of an object
+       * parameter is not present.
+       *
+       * @param name The name of the parameter.
+       * @param member The key or path of the missing member.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode ParameterMemberMissing(const std::string& name, const std::string& member) {
+        return ErrorCode(
+          Code(ErrorCodes::PARAMETER_MISSING),
+          (boost::format("Member \"%1%\" of parameter \"%2%\" is missing") % member % name).str(),
+          "name", name,
+          "member", member
+        );
+      }
+
+      /**
+       * @brief Parameter member wrong type
+       *
+       * Factory method to create an \p ErrorCode, if a member of an object
+       * parameter has an unexpected data type.
+       *
+       * @param name The name of the parameter.
+       * @param member The key or path of the failing member.
+       * @param actual The actual data type of the member.
+       * @param expected The expected data type of the member.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode ParameterMemberWrongType(const std::string& name, const std::string& member, util::JsonType actual, util::JsonType expected) {
+        return ErrorCode(
+          Code(ErrorCodes::PARAMETER_WRONG_TYPE),
+          (boost::format("Member \"%1%\" of parameter \"%2%\" is of type \"%3%\", expected \"%4%\"") % member % name % GetJsonTypeName(actual) % GetJsonTypeName(expected)).str(),
+          "name", name,
+          "member", member,
+          "actual", GetJsonTypeName(actual),
+          "expected", GetJsonTypeName(expected)
+        );
+      }
+
       /**
        * @brief Parameter value missing
        *
@@ -898,6 +993,89 @@ namespace ts7 {
         return ErrorCode::WrongType(Code(ErrorCodes::RESULT_WRONG_TYPE), "result", actual, expected);
       }
 
+      /**
+       * @brief Call timeout
+       *
+       * Factory method to create an \p ErrorCode, if no response was
+       * received before the deadline of a call.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode CallTimeout() {
+        return ErrorCode(Code(ErrorCodes::CALL_TIMEOUT), "Call timed out");
+      }
+
+      /**
+       * @brief Call cancelled
+       *
+       * Factory method to create an \p ErrorCode, if a call got cancelled
+       * before a response was received.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode CallCancelled() {
+        return ErrorCode(Code(ErrorCodes::CALL_CANCELLED), "Call cancelled");
+      }
+
+      /**
+       * @brief Error data wrong type
+       *
+       * Factory method to create an \p ErrorCode, if the data field of
+       * an error has an unexpected data type.
+       *
+       * @param actual The actual data type of the data field.
+       * @param expected The expected data type of the data field.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode ErrorDataWrongType(util::JsonType actual, util::JsonType expected) {
+        return ErrorCode::WrongType(Code(ErrorCodes::ERROR_DATA_WRONG_TYPE), "data", actual, expected);
+      }
+
+      /**
+       * @brief Server busy
+       *
+       * Factory method to create an \p ErrorCode, if the server rejected a
+       * request, because it is overloaded.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode ServerBusy() {
+        return ErrorCode(Code(ErrorCodes::SERVER_BUSY), "Server busy");
+      }
+
+      /**
+       * @brief Call id pending
+       *
+       * Factory method to create an \p ErrorCode, if a call could not be
+       * registered, because a call with the same id is already pending.
+       *
+       * @return Returns the created \p ErrorCode.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      [[maybe_unused]] static inline ErrorCode CallIdPending() {
+        return ErrorCode(Code(ErrorCodes::CALL_ID_PENDING), "Call with the same id is already pending");
+      }
+
       struct Exception : public std::runtime_error {
         using source_location = std::experimental::source_location;
 
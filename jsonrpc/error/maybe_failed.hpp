@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <utility>
 
 namespace ts7 {
   namespace jsonrpc {
@@ -56,6 +57,25 @@ namespace ts7 {
            succeeded(true)
         {}
 
+        /**
+         * @brief constructor
+         *
+         * Creates the maybe_failed object for a successful case and
+         * moves the success object inside. This avoids copying large
+         * success values like converted arrays.
+         *
+         * @param success Success instance that shall be moved.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        constexpr inline maybe_failed(TSuccess&& success)
+         : success(std::move(success)),
+           failed(TFailed()),
+           succeeded(true)
+        {}
+
         /**
          * @brief constructor
          *
@@ -95,10 +115,15 @@ namespace ts7 {
          *
          * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
          */
-        constexpr inline const TSuccess& getSuccess() const {
+        constexpr inline const TSuccess& getSuccess() const & {
           return success;
         }
 
+        /// Moves the success instance out of an expiring object
+        constexpr inline TSuccess getSuccess() && {
+          return std::move(success);
+        }
+
         /**
          * @brief Failure value
          *
@@ -291,10 +316,15 @@ namespace ts7 {
         /// assignment operator
         constexpr maybe_failed& operator=(maybe_failed&&) = default;
 
-        constexpr inline const TSuccess& getSuccess() const {
+        constexpr inline const TSuccess& getSuccess() const & {
           return success;
         }
 
+        /// Moves the success instance out of an expiring object
+        constexpr inline TSuccess getSuccess() && {
+          return std::move(success);
+        }
+
         /**
          * @brief Success cast operator
          *
@@ -830,10 +860,15 @@ namespace ts7 {
          *
          * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
          */
-        constexpr inline const TSuccess& getSuccess() const {
+        constexpr inline const TSuccess& getSuccess() const & {
           return success;
         }
 
+        /// Moves the success instance out of an expiring object
+        constexpr inline TSuccess getSuccess() && {
+          return std::move(success);
+        }
+
         /**
          * @brief Failure value
          *
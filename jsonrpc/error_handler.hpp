@@ -53,7 +53,7 @@ namespace ts7 {
             return static_cast<error::ErrorCode>(jsonrpc);
           }
 
-          id_failure id = checkJsonrpc(e);
+          id_failure id = checkId(e);
           if (!id) {
             return static_cast<error::ErrorCode>(id);
           }
@@ -90,12 +90,23 @@ namespace ts7 {
             return error::ErrorCallbackMissing();
           }
 
-          util::FromJson<TId> id_value;
           util::FromJson<std::int32_t> code;
           util::FromJson<std::string> message;
-          util::FromJson<TData> data;
 
-          callback(id_value(id), code(errorCode), message(errorMessage), data(errorObj.at("data")));
+          // The data field is optional
+          TData data = TData();
+          if (const boost::json::value* errorData = errorObj.if_contains("data")) {
+            util::FromJson<TData> data_value;
+            typename util::FromJson<TData>::conversion_failure converted = data_value(*errorData);
+            if (!converted) {
+              return error::ErrorDataWrongType(converted.getFailed(), util::AsJson<TData>::type);
+            }
+
+            data = converted.getSuccess();
+          }
+
+          callback(static_cast<TId>(id), code(errorCode), message(errorMessage), data);
+          return maybe_failed();
         }
 
       protected:
@@ -124,12 +135,12 @@ namespace ts7 {
 
           const boost::json::value& id = e.at("id");
           util::JsonType actual = util::GetJsonType(id);
-          if (util::AsJson<TId>::IsType(actual)) {
+          if (!util::AsJson<TId>::IsType(actual)) {
             return error::IdWrongType<TId>(actual);
           }
 
           util::FromJson<TId> value;
-          return value(id);
+          return static_cast<TId>(value(id));
         }
 
         callback_t callback;
@@ -249,7 +260,7 @@ namespace ts7 {
 
           const boost::json::value& id = e.at("id");
           util::JsonType actual = util::GetJsonType(id);
-          if (util::AsJson<TId>::IsType(actual)) {
+          if (!util::AsJson<TId>::IsType(actual)) {
             return error::IdWrongType<TId>(actual);
           }
 
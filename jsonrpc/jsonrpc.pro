@@ -13,11 +13,20 @@ SOURCES += \
 
 HEADERS += \
     util/asjson.hpp \
+    util/admission_control.hpp \
+    util/executor.hpp \
+    util/sharded_executor.hpp \
+    util/thread_pool.hpp \
+    util/awaitable.hpp \
     util/fromjson.hpp \
     util/always_false.hpp \
+    util/arrayview.hpp \
+    util/describe.hpp \
     util/remove_cref.hpp \
+    util/timerwheel.hpp \
     util/jsontype.hpp \
     util/jsonstreamer.hpp \
+    util/msgpack.hpp \
     util/fsm.hpp \
     util/util.hpp \
     util/observer.hpp \
@@ -26,11 +35,14 @@ HEADERS += \
     error/error.hpp \
     com/tcpserver.hpp \
     com/tcpconnection.hpp \
+    com/tcpclient.hpp \
+    com/io_context_pool.hpp \
     parameter.hpp \
     error.hpp \
     notification.hpp \
     request.hpp \
     response.hpp \
+    result_stream.hpp \
     error_handler.hpp \
     notification_handler.hpp \
     request_handler.hpp \
@@ -39,6 +51,9 @@ HEADERS += \
     module.hpp \
     jsonrpc.hpp \
     call.hpp \
+    call_store.hpp \
+    async_call.hpp \
+    batcher.hpp \
     notify.hpp
 
 # Default rules for deployment.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <exception>
 #include <functional>
 #include <map>
 #include <string>
@@ -7,7 +8,9 @@
 #include <boost/json.hpp>
 
 #include "error.hpp"
+#include "result_stream.hpp"
 #include "error/error.hpp"
+#include "util/executor.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
@@ -16,8 +19,101 @@ namespace ts7 {
       public:
         using id_t = TId;
         using procedure_t = std::function<boost::json::value(const boost::json::object&)>;
+        using stream_procedure_t = std::function<ResultStream(const boost::json::object&)>;
+
+        /// Scheduling of a procedure
+        struct Scheduling {
+            /// Scheduling class on the executor
+            util::SchedulingClass cls = util::SchedulingClass::NORMAL;
+
+            /// Runs on the I/O thread instead of the executor
+            bool run_inline = false;
+        };
 
         inline boost::json::value operator()(const boost::json::object& request) {
+          return dispatch(request, nullptr);
+        }
+
+        /**
+         * @brief Streaming call
+         *
+         * Handles the request like the call operator, but leaves the result
+         * of streaming procedures in \p stream instead of materializing it.
+         *
+         * @param request The received request.
+         * @param stream Receives the result of a streaming procedure.
+         *
+         * @return Returns the response of all other procedures. Returns null,
+         * if the response got stored in \p stream.
+         */
+        inline boost::json::value operator()(const boost::json::object& request, ResultStream& stream) {
+          return dispatch(request, &stream);
+        }
+
+        /**
+         * @brief Add request
+         *
+         * @param name Method name of the request.
+         * @param procedure Procedure, that handles the request.
+         * @param cls Scheduling class of the procedure.
+         * @param run_inline Runs the procedure directly on the I/O thread,
+         * which receives the request. Only suits procedures, that take
+         * less time than the hand over to a worker thread.
+         */
+        inline void addRequest(const std::string& name, procedure_t procedure, util::SchedulingClass cls = util::SchedulingClass::NORMAL, bool run_inline = false) {
+          procedures[name] = Entry::Request(procedure, Scheduling{cls, run_inline});
+        }
+
+        inline void addStreamingRequest(const std::string& name, stream_procedure_t procedure, util::SchedulingClass cls = util::SchedulingClass::NORMAL) {
+          // The rows are produced by the executor after the call returned. They may view into the
+          // request, which only the connection's executor path keeps alive for the stream.
+          procedures[name] = Entry::StreamingRequest(procedure, Scheduling{cls, false});
+        }
+
+        inline void addNotification(const std::string& name, procedure_t procedure, util::SchedulingClass cls = util::SchedulingClass::NORMAL, bool run_inline = false) {
+          procedures[name] = Entry::Notification(procedure, Scheduling{cls, run_inline});
+        }
+
+        /**
+         * @brief Scheduling
+         *
+         * @param request The received request or notification.
+         *
+         * @return Returns how the called procedure is scheduled. Unknown
+         * methods are \p SchedulingClass::NORMAL and not inline.
+         */
+        inline Scheduling getScheduling(const boost::json::object& request) const {
+          const boost::json::value* method = request.if_contains("method");
+          if (nullptr == method || !method->is_string()) {
+            return Scheduling();
+          }
+
+          typename std::map<std::string, Entry>::const_iterator it = procedures.find(std::string(method->as_string()));
+          return (it == procedures.end()) ? Scheduling() : it->second.scheduling;
+        }
+
+        inline void setFallback(procedure_t procedure) {
+          fallback = procedure;
+        }
+
+        /**
+         * @brief Reject
+         *
+         * Answers \p request with the error \p code without calling its
+         * procedure.
+         *
+         * @param request The received request or notification.
+         * @param code The error, that shall be responded.
+         *
+         * @return Returns the error response. Returns null for
+         * notifications, they are not answered.
+         */
+        inline boost::json::value reject(const boost::json::object& request, const error::ErrorCode& code) {
+          return generateErrorIfRequired(getID(request), code);
+        }
+
+      protected:
+        inline boost::json::value dispatch(const boost::json::object& request, ResultStream* stream) {
           error::maybe_failed<TId, boost::json::object> id = getID(request);
 
           if (!request.contains("method")) {
@@ -46,7 +142,11 @@ namespace ts7 {
           boost::json::value jsonrpc_check = ensureJsonrpc(request, id);
 
           std::string method = str_conv(method_value);
-          const Entry& entry = procedures[method];
+
+          // Requests are dispatched concurrently, never insert here
+          static const Entry unknown;
+          typename std::map<std::string, Entry>::const_iterator it = procedures.find(method);
+          const Entry& entry = (it == procedures.end()) ? unknown : it->second;
           if ( !entry.isValid() && fallback) {
             // Do not perform checks in this case
             // fallback is fully in charge of it
@@ -70,7 +170,7 @@ namespace ts7 {
                 return jsonrpc_check;
               }
 
-              return handleRequest(request, id.getSuccess(), entry);
+              return handleRequest(request, id.getSuccess(), entry, stream);
             }
 
 
@@ -87,19 +187,6 @@ namespace ts7 {
           return handleNotification(request, entry);
         }
 
-        inline void addRequest(const std::string& name, procedure_t procedure) {
-          procedures[name] = Entry::Request(procedure);
-        }
-
-        inline void addNotification(const std::string& name, procedure_t procedure) {
-          procedures[name] = Entry::Notification(procedure);
-        }
-
-        inline void setFallback(procedure_t procedure) {
-          fallback = procedure;
-        }
-
-      protected:
         struct Entry {
             inline Entry() = default;
             inline Entry(const Entry&) = default;
@@ -108,13 +195,24 @@ namespace ts7 {
             Entry& operator=(const Entry&) = default;
             Entry& operator=(Entry&&) = default;
 
-            inline Entry(procedure_t procedure, bool requires_id)
+            inline Entry(procedure_t procedure, bool requires_id, Scheduling scheduling)
               : procedure(procedure),
-                requires_id(requires_id)
+                requires_id(requires_id),
+                scheduling(scheduling)
+            {}
+
+            inline Entry(stream_procedure_t stream, Scheduling scheduling)
+              : stream(stream),
+                requires_id(true),
+                scheduling(scheduling)
             {}
 
             inline bool isValid() const {
-              return (nullptr != procedure);
+              return (nullptr != procedure) || (nullptr != stream);
+            }
+
+            inline bool isStreaming() const {
+              return (nullptr != stream);
             }
 
             inline bool requiresID() const {
@@ -125,16 +223,22 @@ namespace ts7 {
               return procedure;
             }
 
-            static inline Entry Request(procedure_t procedure) {
-              return Entry{procedure, true};
+            static inline Entry Request(procedure_t procedure, Scheduling scheduling) {
+              return Entry{procedure, true, scheduling};
+            }
+
+            static inline Entry Notification(procedure_t procedure, Scheduling scheduling) {
+              return Entry{procedure, false, scheduling};
             }
 
-            static inline Entry Notification(procedure_t procedure) {
-              return Entry{procedure, false};
+            static inline Entry StreamingRequest(stream_procedure_t stream, Scheduling scheduling) {
+              return Entry{stream, scheduling};
             }
 
             procedure_t procedure;
-            bool requires_id;
+            stream_procedure_t stream;
+            bool requires_id = false;
+            Scheduling scheduling;
         };
         error::maybe_failed<TId, boost::json::object> getID(const boost::json::object& request) {
           TId id;
@@ -188,8 +292,23 @@ namespace ts7 {
           return boost::json::value();
         }
 
-        boost::json::value handleRequest(const boost::json::object& request, const TId&, procedure_t procedure) {
-          return procedure(request);
+        boost::json::value handleRequest(const boost::json::object& request, const TId& id, const Entry& entry, ResultStream* stream) {
+          if (!entry.isStreaming()) {
+            return entry.procedure(request);
+          }
+
+          if (nullptr == stream) {
+            // Caller can only take complete responses
+            try {
+              return entry.stream(request).materialize();
+            }
+            catch (const std::exception& e) {
+              return error(id, error::InternalError("reason", std::string(e.what())));
+            }
+          }
+
+          *stream = entry.stream(request);
+          return boost::json::value();
         }
 
         boost::json::value handleNotification(const boost::json::object& notification, procedure_t procedure) {
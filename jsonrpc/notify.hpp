@@ -2,8 +2,13 @@
 
 #include <functional>
 #include <future>
+#include <memory>
+#include <utility>
+
+#include <boost/asio.hpp>
 
 #include "notification.hpp"
+#include "util/awaitable.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
@@ -12,6 +17,8 @@ namespace ts7 {
       public:
         using notification_t = Notification<TArgs...>;
         using notification_action_t = std::function<void(const boost::json::object&)>;
+        using written_t = std::function<void(const boost::system::error_code&)>;
+        using write_action_t = std::function<void(const boost::json::object&, written_t)>;
 
         template <typename... UArgs>
         Notify(const std::string& method, notification_action_t notification_action, UArgs... args)
@@ -31,9 +38,111 @@ namespace ts7 {
           return f;
         }
 
+        /**
+         * @brief Post
+         *
+         * Builds the notification and hands it to the notification action in
+         * the calling thread. Unlike the call operator no thread and no future
+         * is created, so this is the path for high notification rates.
+         * Combined with a queueing transport the notifications are coalesced
+         * into few writes.
+         *
+         * @code
+         * Notify<double> temperature("temperature", [conn](const boost::json::object& o) { conn->queue(o); }, "value");
+         * temperature.post(21.5);
+         * @endcode
+         *
+         * @param args The parameter values.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        void post(TArgs... args) {
+          if ( notification_action ) {
+            notification_action(notification(args...));
+          }
+        }
+
+        /**
+         * @brief Asynchronous notify
+         *
+         * Sends the notification without a thread. The completion token is
+         * called with the result of the write, once the notification got
+         * written by the write action. Without a write action the
+         * notification action is used and the token completes right after it.
+         *
+         * @note The completion signature is void(boost::system::error_code).
+         *
+         * @param args The parameter values.
+         * @param token The completion token.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        template <typename CompletionToken>
+        auto async(TArgs... args, CompletionToken&& token) {
+          return boost::asio::async_initiate<CompletionToken, void(boost::system::error_code)>(
+            [this](auto handler, TArgs... args) {
+              using handler_t = typename std::decay<decltype(handler)>::type;
+
+              boost::json::object o = notification(args...);
+              auto executor = boost::asio::get_associated_executor(handler);
+
+              if ( !write_action ) {
+                if ( notification_action ) {
+                  notification_action(o);
+                }
+
+                boost::asio::dispatch(executor, [handler = std::move(handler)]() mutable {
+                  std::move(handler)(boost::system::error_code());
+                });
+                return;
+              }
+
+              std::shared_ptr<handler_t> shared = std::make_shared<handler_t>(std::move(handler));
+              write_action(o, [shared, executor](const boost::system::error_code& error) {
+                boost::asio::dispatch(executor, [shared, error]() mutable {
+                  std::move(*shared)(error);
+                });
+              });
+            },
+            token,
+            args...
+          );
+        }
+
+#ifdef TS7_JSONRPC_HAS_COROUTINES
+        /**
+         * @brief Awaitable notify
+         *
+         * Allows to await the write of the notification in a C++20 coroutine.
+         *
+         * @param args The parameter values.
+         *
+         * @return Returns the awaitable of the write result.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        auto async(TArgs... args) {
+          return util::MakeAwaitable<boost::system::error_code>([this, args...](auto complete) {
+            async(args..., std::move(complete));
+          });
+        }
+#endif
+
+        /// Sets the action, that writes the notification and reports the completion
+        inline void setWriteAction(write_action_t action) {
+          write_action = action;
+        }
+
       protected:
         notification_t notification;
         notification_action_t notification_action;
+        write_action_t write_action;
     };
   }
 }
@@ -2,6 +2,8 @@
 
 #include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 
 #include "error/error.hpp"
 #include "util/util.hpp"
@@ -57,13 +59,13 @@ namespace ts7 {
           util::FromJson<datatype_t> v;
           if (o.contains(name)) {
             // json object contains the parameter
-            error::maybe_failed<datatype_t, util::JsonType> value = v(o.at(name));
+            typename util::FromJson<datatype_t>::conversion_failure value = v(o.at(name));
             if (value) {
-              // Succeeded: Paramater has correct type
-              return value.getSuccess();
+              // Succeeded: Paramater has correct type, move large values like arrays
+              return std::move(value).getSuccess();
             }
 
-            return error::ParameterWrongType(name, static_cast<util::JsonType>(value), util::AsJson<datatype_t>::type);
+            return wrongType(value.getFailed());
           }
 
           if (hasDefault) {
@@ -86,6 +88,33 @@ namespace ts7 {
 //          return maybe_failed(util::ParameterValueMissing(name));
         }
 
+        /// Wrong type error for scalar values
+        inline error::ErrorCode wrongType(util::JsonType actual) const {
+          return error::ParameterWrongType(name, actual, util::AsJson<datatype_t>::type);
+        }
+
+        /// Wrong type error for arrays, that contains the index of the failing element
+        inline error::ErrorCode wrongType(const util::ArrayElementFailure& failure) const {
+          if (failure.isElement()) {
+            return error::ParameterElementWrongType(name, failure.index, failure.actual, failure.expected);
+          }
+
+          return error::ParameterWrongType(name, failure.actual, util::AsJson<datatype_t>::type);
+        }
+
+        /// Wrong type error for described structures, that names the missing or failing member
+        inline error::ErrorCode wrongType(const util::MemberFailure& failure) const {
+          if (!failure.isMember()) {
+            return error::ParameterWrongType(name, failure.actual, util::AsJson<datatype_t>::type);
+          }
+
+          if (failure.missing) {
+            return error::ParameterMemberMissing(name, failure.member);
+          }
+
+          return error::ParameterMemberWrongType(name, failure.member, failure.actual, failure.expected);
+        }
+
         static constexpr inline Parameter Optional(const std::string& name, const util::remove_cref<U>& defaultValue) {
           return Parameter(name, true, defaultValue);
         }
@@ -97,5 +126,32 @@ namespace ts7 {
         /// Default value, that shall be used if \ref hasDefault is true
         datatype_t defaultValue;
     };
+
+    /**
+     * @brief Loaded check
+     *
+     * Checks if a parameter got loaded successfully and stores the error
+     * into \p failure otherwise.
+     *
+     * @tparam TLoaded The maybe_failed type returned by \ref Parameter::load.
+     *
+     * @param loaded The loaded parameter.
+     * @param failure Receives the error, if the parameter failed to load.
+     *
+     * @return Returns true, if the parameter got loaded successfully.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    template <typename TLoaded>
+    inline bool Loaded(const TLoaded& loaded, error::ErrorCode& failure) {
+      if (!loaded) {
+        failure = loaded.getFailed();
+        return false;
+      }
+
+      return true;
+    }
   }
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <optional>
+#include <string>
+#include <utility>
+
 #include "error.hpp"
 #include "response.hpp"
+#include "result_stream.hpp"
 #include "request_handler.hpp"
 #include "notification_handler.hpp"
 
@@ -17,7 +22,7 @@ namespace ts7 {
         Procedure(callback_t callback, UArgs... args)
           : handler([callback](const TId&, TArgs... args) -> handler_failure {
               try {
-                return callback(args...);
+                return callback(std::forward<TArgs>(args)...);
               }
               catch(error::Exception& e) {
                 return e.ec;
@@ -58,7 +63,7 @@ namespace ts7 {
         Procedure(callback_t callback, UArgs... args)
           : handler([callback](const TId&, TArgs... args) -> handler_failure {
               try {
-                callback(args...);
+                callback(std::forward<TArgs>(args)...);
                 return handler_failure();
               }
               catch(error::Exception& e) {
@@ -89,6 +94,66 @@ namespace ts7 {
         Error<TId> error;
     };
 
+    template <typename TId, typename TRow, typename... TArgs>
+    class StreamingProcedure {
+      public:
+        /// Yields the next row, an empty optional ends the result
+        using generator_t = std::function<std::optional<TRow>()>;
+        using callback_t = std::function<generator_t(TArgs...)>;
+        using handler_failure = typename RequestHandler<TId, generator_t, TArgs...>::maybe_failed;
+
+        template <typename... UArgs>
+        StreamingProcedure(callback_t callback, UArgs... args)
+          : handler([callback](const TId&, TArgs... args) -> handler_failure {
+              try {
+                return callback(std::forward<TArgs>(args)...);
+              }
+              catch(error::Exception& e) {
+                return e.ec;
+              }
+              catch(std::exception& e) {
+                return error::ErrorCode(static_cast<std::int32_t>(error::ErrorCodes::INTERNAL_ERROR), e.what());
+              }
+            }, args...)
+        {}
+
+        ResultStream operator()(const boost::json::object& request) {
+          TId id;
+
+          handler_failure state = handler(request, id);
+          if (!state) {
+            const error::ErrorCode ec = state.getFailed();
+            return ResultStream(error(id, ec));
+          }
+
+          // The result array is written row by row, the rows are never collected
+          std::string prefix = "{\"jsonrpc\":\"2.0\",\"id\":";
+          prefix += boost::json::serialize(static_cast<boost::json::value>(util::AsJson<TId>(id)));
+          prefix += ",\"result\":[";
+
+          generator_t generator = state.getSuccess();
+          bool first = true;
+          return ResultStream(prefix, [generator, first](std::string& out) mutable -> bool {
+            std::optional<TRow> row = generator();
+            if (!row) {
+              return false;
+            }
+
+            if (!first) {
+              out += ',';
+            }
+            first = false;
+
+            out += boost::json::serialize(static_cast<boost::json::value>(util::AsJson<TRow>(*row)));
+            return true;
+          }, "]}");
+        }
+
+      protected:
+        RequestHandler<TId, generator_t, TArgs...> handler;
+        Error<TId> error;
+    };
+
     template <typename... TArgs>
     class NotificationProcedure {
       public:
@@ -98,7 +163,7 @@ namespace ts7 {
         template <typename... UArgs>
         NotificationProcedure(callback_t callback, UArgs... args)
           : handler([callback](TArgs... args) -> handler_failure {
-              callback(args...);
+              callback(std::forward<TArgs>(args)...);
               return handler_failure();
             }, Parameter<TArgs>(args)...)
         {}
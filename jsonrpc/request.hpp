@@ -1,18 +1,79 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
 #include "parameter.hpp"
 #include "error/error.hpp"
 #include "util/util.hpp"
 
 namespace ts7 {
   namespace jsonrpc {
+    /// Block size of \ref RequestID: 64 ids, but at most a sixteenth of the id range
+    template <typename TId>
+    constexpr std::size_t RequestIDBlockSize() {
+      if constexpr (std::is_integral<TId>::value) {
+        const std::size_t range = static_cast<std::size_t>(std::numeric_limits<TId>::max()) / 16;
+        return (range < 64) ? ((range > 0) ? range : 1) : 64;
+      }
+      else {
+        return 1;
+      }
+    }
+
+    /**
+     * @brief Request id generator
+     *
+     * Generates unique request ids from any thread. Integral ids are handed
+     * out in blocks of \ref block_size: every thread reserves a block from a
+     * shared atomic counter and then generates ids from its block without
+     * any synchronization. The shared counter is only touched once per block.
+     *
+     * @note Ids are unique, but only increasing per thread. The blocks are
+     * small, so the ids of up to 64 threads still fit into the 4096 slots of
+     * \ref RingCallStore at once. Other id types need a prefix increment and
+     * are generated under a lock.
+     *
+     * @tparam TId Data type of the ids.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
     template <typename TId>
     struct RequestID {
       using type = TId;
 
+        /// Amount of ids, that a thread reserves at once
+        static constexpr const std::size_t block_size = RequestIDBlockSize<TId>();
+
         static TId generate() {
-          static TId id = TId();
-          return ++id;
+          if constexpr (std::is_integral<TId>::value) {
+            // Unsigned arithmetic wraps around at the end of the id range
+            using unsigned_t = typename std::make_unsigned<TId>::type;
+
+            static std::atomic<TId> next{TId(1)};
+            thread_local unsigned_t current = 0;
+            thread_local std::size_t remaining = 0;
+
+            if (0 == remaining) {
+              current = static_cast<unsigned_t>(next.fetch_add(static_cast<TId>(block_size), std::memory_order_relaxed));
+              remaining = block_size;
+            }
+
+            --remaining;
+            return static_cast<TId>(current++);
+          }
+          else {
+            static std::mutex m;
+            static TId id = TId();
+
+            std::lock_guard<std::mutex> lock(m);
+            return ++id;
+          }
         }
     };
 
@@ -94,7 +94,9 @@ namespace ts7 {
          *
          * @param o Const reference to the JSON object that shall be parsed.
          *
-         * @return Returns the result of the stored function pointer.
+         * @return Returns the result of the stored function pointer. If any parameter
+         * could not be loaded, the error of the first failing parameter is returned
+         * instead and the function pointer is not executed.
          *
          * @since 1.0
          *
@@ -102,7 +104,14 @@ namespace ts7 {
          */
         template <std::size_t... Is>
         maybe_failed apply(const TId& id, const boost::json::object& o, std::index_sequence<Is...>) {
-           return callback( id, std::get<Is>(parameter).load(o) ... );
+           std::tuple<typename Parameter<TArgs>::maybe_failed...> loaded{ std::get<Is>(parameter).load(o) ... };
+
+           error::ErrorCode failure;
+           if (!(Loaded(std::get<Is>(loaded), failure) && ...)) {
+             return failure;
+           }
+
+           return callback( id, std::move(std::get<Is>(loaded)).getSuccess() ... );
         }
     };
 
@@ -198,7 +207,9 @@ namespace ts7 {
          *
          * @param o Const reference to the JSON object that shall be parsed.
          *
-         * @return Returns the result of the stored function pointer.
+         * @return Returns the result of the stored function pointer. If any parameter
+         * could not be loaded, the error of the first failing parameter is returned
+         * instead and the function pointer is not executed.
          *
          * @since 1.0
          *
@@ -206,7 +217,14 @@ namespace ts7 {
          */
         template <std::size_t... Is>
         maybe_failed apply(const TId& id, const boost::json::object& o, std::index_sequence<Is...>) {
-           return callback( id, std::get<Is>(parameter).load(o) ... );
+           std::tuple<typename Parameter<TArgs>::maybe_failed...> loaded{ std::get<Is>(parameter).load(o) ... };
+
+           error::ErrorCode failure;
+           if (!(Loaded(std::get<Is>(loaded), failure) && ...)) {
+             return failure;
+           }
+
+           return callback( id, std::move(std::get<Is>(loaded)).getSuccess() ... );
         }
     };
   }
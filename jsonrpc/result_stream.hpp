@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <boost/json.hpp>
+#include <boost/log/trivial.hpp>
+
+namespace ts7 {
+  namespace jsonrpc {
+    /**
+     * @brief Result stream
+     *
+     * Serialized response, that is produced chunk by chunk. Streaming
+     * procedures use it to send large results without building the complete
+     * JSON document. Only the current chunk is held in memory.
+     *
+     * A stream either holds a complete response, which is serialized at once,
+     * or a prefix, a row writer and a suffix. The row writer appends one
+     * serialized row per call and returns false after the last row.
+     *
+     * @since 1.0
+     *
+     * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+     */
+    class ResultStream {
+      public:
+        /// Appends the next serialized row, returns false if there are no more rows
+        using row_writer_t = std::function<bool(std::string&)>;
+
+        /// Default chunk size in bytes
+        static constexpr const std::size_t default_chunk_size = 64 * 1024;
+
+        /// default constructor, creates an empty stream
+        inline ResultStream() = default;
+
+        /**
+         * @brief constructor
+         *
+         * Creates a stream of an already complete response, e.g. an error.
+         *
+         * @param complete The complete response.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline explicit ResultStream(boost::json::value complete)
+          : complete(std::move(complete))
+        {}
+
+        /**
+         * @brief constructor
+         *
+         * Creates a stream of rows, that are enclosed by \p prefix and \p suffix.
+         *
+         * @param prefix Serialized data before the first row.
+         * @param rows Writer of the serialized rows.
+         * @param suffix Serialized data after the last row.
+         * @param chunk_size Size a chunk is filled up to before it is returned.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline ResultStream(std::string prefix, row_writer_t rows, std::string suffix, std::size_t chunk_size = default_chunk_size)
+          : prefix(std::move(prefix)),
+            rows(std::move(rows)),
+            suffix(std::move(suffix)),
+            chunk_size(chunk_size)
+        {}
+
+        /// Returns true, if the stream has nothing to send
+        inline bool empty() const {
+          return complete.is_null() && !rows;
+        }
+
+        /**
+         * @brief Next chunk
+         *
+         * Replaces \p chunk with the next part of the serialized response.
+         *
+         * @note If the row writer throws, the stream fails: it is finished
+         * without the suffix, \p chunk is cleared and \ref hasFailed returns
+         * true. The response is incomplete, the caller needs to abort it.
+         *
+         * @param chunk Receives the next chunk.
+         *
+         * @return Returns false, if the stream is finished and \p chunk was
+         * not filled.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline bool next(std::string& chunk) {
+          chunk.clear();
+
+          if (!complete.is_null()) {
+            if (finished) {
+              return false;
+            }
+
+            chunk = boost::json::serialize(complete);
+            finished = true;
+            return true;
+          }
+
+          if (finished || !rows) {
+            return false;
+          }
+
+          if (!started) {
+            chunk = prefix;
+            started = true;
+          }
+
+          bool more = true;
+          while (more && chunk.size() < chunk_size) {
+            try {
+              more = rows(chunk);
+            }
+            catch (std::exception& e) {
+              BOOST_LOG_TRIVIAL(error) << "Result stream aborted: " << e.what();
+              failure = e.what();
+              failed = true;
+              finished = true;
+              chunk.clear();
+              return false;
+            }
+          }
+
+          if (!more) {
+            chunk += suffix;
+            finished = true;
+          }
+
+          return true;
+        }
+
+        /**
+         * @brief Materialize
+         *
+         * Builds the complete response. This is used, whenever the response
+         * cannot be streamed, e.g. for binary wire formats or direct calls of
+         * the module.
+         *
+         * @return Returns the complete response.
+         *
+         * @throws std::runtime_error, if the row writer failed.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline boost::json::value materialize() {
+          if (!complete.is_null() || !rows) {
+            return complete;
+          }
+
+          std::string data;
+          std::string chunk;
+          while (next(chunk)) {
+            data += chunk;
+          }
+
+          if (failed) {
+            throw std::runtime_error(failure);
+          }
+
+          return boost::json::parse(data);
+        }
+
+        /// Returns true, if the row writer threw and the response is incomplete
+        inline bool hasFailed() const {
+          return failed;
+        }
+
+        /**
+         * @brief Keep
+         *
+         * Keeps \p owner alive as long as the stream. The rows are written
+         * after the procedure returned, parameters like std::string_view or
+         * \ref util::ArrayView still point into the request. The caller
+         * passes the request here, if it would be destroyed before the
+         * stream is finished.
+         *
+         * @param owner Owner of the data, the row writer refers to.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline void keep(std::shared_ptr<const void> owner) {
+          this->owner = std::move(owner);
+        }
+
+      protected:
+        /// Complete response
+        boost::json::value complete;
+
+        /// Serialized data before the rows
+        std::string prefix;
+
+        /// Row writer
+        row_writer_t rows;
+
+        /// Serialized data after the rows
+        std::string suffix;
+
+        /// Chunk size in bytes
+        std::size_t chunk_size = default_chunk_size;
+
+        /// Prefix got returned
+        bool started = false;
+
+        /// Suffix got returned or the stream failed
+        bool finished = false;
+
+        /// Row writer threw
+        bool failed = false;
+
+        /// Message of the failure
+        std::string failure;
+
+        /// Data the row writer refers to, e.g. the request
+        std::shared_ptr<const void> owner;
+    };
+  }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/log/trivial.hpp>
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Admission control
+       *
+       * CoDel style load shedding for received requests. The executor tasks
+       * report how long they waited in the queue. A single slow task is
+       * tolerated, but when the queueing delay stays above \p target for a
+       * whole \p interval, the server is overloaded and new requests are
+       * rejected instead of queued. The first task, that waited less than
+       * \p target, or an empty queue ends the overload.
+       *
+       * Requests, that would wait for seconds and time out on the client
+       * anyway, are answered immediately, which keeps the delay of the
+       * admitted requests bounded.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class AdmissionControl {
+        public:
+          using clock_t = std::chrono::steady_clock;
+
+          /**
+           * @brief constructor
+           *
+           * @param target Acceptable queueing delay.
+           * @param interval Time the delay needs to stay above \p target,
+           * before requests are rejected.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit AdmissionControl(std::chrono::nanoseconds target = std::chrono::milliseconds(5), std::chrono::nanoseconds interval = std::chrono::milliseconds(100))
+            : target(target),
+              interval(interval.count())
+          {}
+
+          AdmissionControl(const AdmissionControl&) = delete;
+          AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+          /**
+           * @brief Enqueue
+           *
+           * Counts an admitted task, that gets queued now. Every queued task
+           * needs to be reported by \ref record, once it starts.
+           *
+           * @return Returns the time, when the task got queued.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline clock_t::time_point enqueue() {
+            queued.fetch_add(1, std::memory_order_relaxed);
+            return clock_t::now();
+          }
+
+          /**
+           * @brief Record
+           *
+           * Records the queueing delay of a task, that starts now.
+           *
+           * @param queued Time, when the task got queued.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void record(clock_t::time_point queued) {
+            this->queued.fetch_sub(1, std::memory_order_relaxed);
+
+            const clock_t::time_point now = clock_t::now();
+            const std::int64_t t = Nanoseconds(now);
+
+            if (now - queued < target) {
+              firstAbove.store(0, std::memory_order_relaxed);
+              if (overloaded.load(std::memory_order_relaxed)) {
+                overloaded.store(false, std::memory_order_relaxed);
+                BOOST_LOG_TRIVIAL(info) << "Queueing delay below target, admitting requests again";
+              }
+
+              return;
+            }
+
+            std::int64_t first = firstAbove.load(std::memory_order_relaxed);
+            if (0 == first) {
+              // Above the target for the first time, give it an interval
+              firstAbove.compare_exchange_strong(first, t + interval, std::memory_order_relaxed);
+              return;
+            }
+
+            if (t >= first && !overloaded.exchange(true, std::memory_order_relaxed)) {
+              BOOST_LOG_TRIVIAL(warning) << "Queueing delay above target for an interval, rejecting requests";
+            }
+          }
+
+          /**
+           * @brief Admit
+           *
+           * @return Returns whether a new request shall be queued. Counts
+           * the rejected requests.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          bool admit() {
+            if (!overloaded.load(std::memory_order_relaxed)) {
+              return true;
+            }
+
+            if (0 == queued.load(std::memory_order_relaxed)) {
+              // The queue drained, no request waits anymore
+              firstAbove.store(0, std::memory_order_relaxed);
+              overloaded.store(false, std::memory_order_relaxed);
+              return true;
+            }
+
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+          }
+
+          inline bool isOverloaded() const {
+            return overloaded.load(std::memory_order_relaxed);
+          }
+
+          /// Returns the amount of rejected requests
+          inline std::size_t getRejected() const {
+            return rejected.load(std::memory_order_relaxed);
+          }
+
+        protected:
+          static inline std::int64_t Nanoseconds(clock_t::time_point t) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+          }
+
+          /// Acceptable queueing delay
+          const std::chrono::nanoseconds target;
+
+          /// Time in nanoseconds the delay needs to stay above the target
+          const std::int64_t interval;
+
+          /// End of the interval of the first delay above the target, zero if the delay is below
+          std::atomic<std::int64_t> firstAbove{0};
+
+          /// Amount of queued tasks, that did not start yet
+          std::atomic<std::size_t> queued{0};
+
+          /// Requests are rejected
+          std::atomic<bool> overloaded{false};
+
+          /// Amount of rejected requests
+          std::atomic<std::size_t> rejected{0};
+      };
+    }
+  }
+}
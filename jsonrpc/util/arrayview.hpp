@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "asjson.hpp"
+#include "fromjson.hpp"
+#include "jsontype.hpp"
+#include "../error/error.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief View element
+       *
+       * Type check and extraction of the elements an \ref ArrayView can
+       * provide. Every supported element type needs its own specialization.
+       *
+       * @tparam T The element type.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T, typename = void>
+      struct ViewElement {
+          static_assert(always_false<T>, "Unsupported array view element type");
+      };
+
+      /// Arithmetic view elements
+      template <typename T>
+      struct ViewElement<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> : public ArithmeticElement<T> {};
+
+      /// String view elements, pointing into the JSON document
+      template <>
+      struct ViewElement<std::string_view> {
+          static inline bool Accepts(const boost::json::value& v) {
+            return v.is_string();
+          }
+
+          static inline std::string_view Extract(const boost::json::value& v) {
+            const boost::json::string& s = v.get_string();
+            return std::string_view(s.data(), s.size());
+          }
+      };
+
+      /**
+       * @brief Array view
+       *
+       * Read only view on a JSON array, that converts its elements on access.
+       * It can be used as parameter type of procedures to avoid copying large
+       * arrays out of the request.
+       *
+       * @attention The view points into the storage of the JSON document. It
+       * is only valid as long as the document is alive and unchanged. For
+       * parameters this is the duration of the procedure call.
+       *
+       * @tparam T The element type. Supported are arithmetic types and
+       * std::string_view.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      class ArrayView {
+        public:
+          using value_type = T;
+          using size_type = std::size_t;
+
+          /// Iterator over the converted elements
+          class const_iterator {
+            public:
+              using iterator_category = std::forward_iterator_tag;
+              using value_type = T;
+              using difference_type = std::ptrdiff_t;
+              using pointer = void;
+              using reference = T;
+
+              inline explicit const_iterator(const boost::json::value* it = nullptr)
+                : it(it)
+              {}
+
+              inline T operator*() const {
+                return ViewElement<T>::Extract(*it);
+              }
+
+              inline const_iterator& operator++() {
+                ++it;
+                return *this;
+              }
+
+              inline const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++it;
+                return old;
+              }
+
+              inline bool operator==(const const_iterator& other) const {
+                return it == other.it;
+              }
+
+              inline bool operator!=(const const_iterator& other) const {
+                return it != other.it;
+              }
+
+            protected:
+              const boost::json::value* it;
+          };
+
+          /// default constructor, creates an empty view
+          inline ArrayView() = default;
+
+          /**
+           * @brief constructor
+           *
+           * Creates a view on the provided array.
+           *
+           * @note The elements are not checked. Use \ref FromJson to create
+           * a view on validated elements.
+           *
+           * @param a The array that shall be viewed.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit ArrayView(const boost::json::array& a)
+            : elements(a.data()),
+              count(a.size())
+          {}
+
+          inline size_type size() const {
+            return count;
+          }
+
+          inline bool empty() const {
+            return 0 == count;
+          }
+
+          inline T operator[](size_type i) const {
+            return ViewElement<T>::Extract(elements[i]);
+          }
+
+          inline const_iterator begin() const {
+            return const_iterator(elements);
+          }
+
+          inline const_iterator end() const {
+            return const_iterator(elements + count);
+          }
+
+          /// Copies all elements into a std::vector
+          inline std::vector<T> toVector() const {
+            std::vector<T> data(count);
+            for (size_type i = 0; i < count; ++i) {
+              data[i] = ViewElement<T>::Extract(elements[i]);
+            }
+
+            return data;
+          }
+
+        protected:
+          /// First element of the viewed array
+          const boost::json::value* elements = nullptr;
+
+          /// Amount of elements
+          size_type count = 0;
+      };
+
+      /**
+       * @brief Array view from JSON
+       *
+       * Creates an \ref ArrayView on a boost::json::value, after all elements
+       * got checked to have the expected type.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct FromJson<ArrayView<T>> {
+          /// Conversion failure data type
+          using conversion_failure = error::maybe_failed<ArrayView<T>, ArrayElementFailure>;
+
+          /// default constructor
+          inline FromJson() = default;
+
+          /**
+           * @brief Conversion
+           *
+           * Checks all elements and creates the view.
+           *
+           * @param v The value that shall be viewed.
+           *
+           * @return Returns the view, if successful. If the value or one of
+           * its elements has the wrong type, the actual type and the index of
+           * the failing element will be returned.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline conversion_failure operator()(const boost::json::value& v) const {
+            if (!v.is_array()) {
+              return ArrayElementFailure(GetJsonType(v));
+            }
+
+            const boost::json::array& a = v.as_array();
+            const boost::json::value* elements = a.data();
+            for (std::size_t i = 0; i < a.size(); ++i) {
+              if (!ViewElement<T>::Accepts(elements[i])) {
+                return ArrayElementFailure(GetJsonType(elements[i]), AsJson<T>::type, i);
+              }
+            }
+
+            return conversion_failure(ArrayView<T>(a));
+          }
+      };
+
+      /**
+       * @brief Convert array view to json
+       *
+       * Converts the viewed elements back to a json array.
+       *
+       * @note This is the template specialization of \ref AsJson.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct AsJson<ArrayView<T>> {
+          static constexpr const JsonType type = JsonType::ARRAY;
+
+          static inline constexpr bool IsType(JsonType t) {
+            return type == t;
+          }
+
+          inline explicit AsJson(const ArrayView<T>& value)
+            : value(value)
+          {}
+
+          operator boost::json::value() const {
+            boost::json::array a;
+            a.reserve(value.size());
+
+            for (const T& t : value) {
+              a.push_back(AsJson<T>(t));
+            }
+
+            return a;
+          }
+
+          /// The stored view
+          ArrayView<T> value;
+      };
+    }
+  }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <experimental/source_location>
 
 #include "always_false.hpp"
@@ -561,6 +565,52 @@ namespace ts7 {
           std::string value;
       };
 
+      /**
+       * @brief Convert string view to json
+       *
+       * Converts a std::string_view to a json string.
+       *
+       * @note This is the template specialization of \ref AsJson.
+       *
+       * @attention Only the view is stored. The referenced characters need to
+       * be alive until the conversion to the json value happened.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template<>
+      struct AsJson<std::string_view> {
+          static constexpr const JsonType type = JsonType::STRING;
+
+          static inline constexpr bool IsType(JsonType t) {
+            return type == t;
+          }
+
+          /**
+           * @brief constructor
+           *
+           * Stores the provided view for later conversion.
+           *
+           * @param value The view that shall be converted.
+           */
+          constexpr inline explicit AsJson(std::string_view value)
+            : value(value)
+          {}
+
+          /**
+           * @brief Json value cast
+           *
+           * Casts the instance to a json value. In this case to a string with the characters of \ref value.
+           */
+          operator boost::json::value() const {
+            return boost::json::string_view(value.data(), value.size());
+          }
+
+          /// The stored view
+          std::string_view value;
+      };
+
       template<>
       struct AsJson<std::experimental::source_location> {
         static constexpr const JsonType type = JsonType::OBJECT;
@@ -629,16 +679,31 @@ namespace ts7 {
             : value(n)
           {}
 
+          inline explicit AsJson(std::vector<T>&& n)
+            : value(std::move(n))
+          {}
+
           /**
            * @brief Json value cast
            *
-           * Casts the instance to a json value. In this case to a number with the !value stored in \ref value.
+           * Casts the instance to a json value. In this case to an array with the values stored in \ref value.
+           *
+           * @note The array is allocated once with its final size. Arithmetic elements are stored directly,
+           * without creating an intermediate \ref AsJson per element.
            */
           operator boost::json::value() const {
             boost::json::array a;
+            a.reserve(value.size());
 
-            for (const T& t : value) {
-              a.push_back(AsJson<T>(t));
+            if constexpr (std::is_arithmetic<T>::value) {
+              for (const T& t : value) {
+                a.emplace_back(t);
+              }
+            }
+            else {
+              for (const T& t : value) {
+                a.push_back(AsJson<T>(t));
+              }
             }
 
             return a;
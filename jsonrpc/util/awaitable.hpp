@@ -0,0 +1,68 @@
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <functional>
+#include <utility>
+
+/// Defined, if C++20 coroutines are available
+#define TS7_JSONRPC_HAS_COROUTINES 1
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Awaitable
+       *
+       * Adapts an asynchronous operation, that reports its result through a
+       * callback, to co_await. The coroutine is suspended without blocking a
+       * thread and resumed by the thread, that executes the callback.
+       *
+       * @tparam TResult Result of the operation and of the co_await expression.
+       * @tparam TInitiate Starts the operation with the completion callback.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename TResult, typename TInitiate>
+      class Awaitable {
+        public:
+          inline explicit Awaitable(TInitiate initiate)
+            : initiate(std::move(initiate))
+          {}
+
+          inline bool await_ready() const noexcept {
+            return false;
+          }
+
+          inline void await_suspend(std::coroutine_handle<> handle) {
+            // Do not touch the awaitable after the initiation, the coroutine
+            // might already be resumed on another thread.
+            initiate([this, handle](TResult r) mutable {
+              result = std::move(r);
+              handle.resume();
+            });
+          }
+
+          inline TResult await_resume() {
+            return std::move(result);
+          }
+
+        protected:
+          /// Initiation of the operation
+          TInitiate initiate;
+
+          /// Result of the operation
+          TResult result;
+      };
+
+      /// Creates an \ref Awaitable with a deduced initiation type
+      template <typename TResult, typename TInitiate>
+      inline Awaitable<TResult, TInitiate> MakeAwaitable(TInitiate initiate) {
+        return Awaitable<TResult, TInitiate>(std::move(initiate));
+      }
+    }
+  }
+}
+#endif
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <boost/json.hpp>
+#include <boost/preprocessor/seq/enum.hpp>
+#include <boost/preprocessor/seq/transform.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/variadic/to_seq.hpp>
+
+#include "asjson.hpp"
+#include "fromjson.hpp"
+#include "jsontype.hpp"
+#include "remove_cref.hpp"
+#include "../error/error.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Described member
+       *
+       * Compile time entry of a key table. It connects the JSON key with the
+       * pointer to the member, that holds the value.
+       *
+       * @tparam T The described structure.
+       * @tparam TMember The data type of the member.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T, typename TMember>
+      struct Member {
+          /// Member data type
+          using type = TMember;
+
+          /// JSON key of the member
+          std::string_view key;
+
+          /// Pointer to the member
+          TMember T::* pointer;
+      };
+
+      /// Creates a \ref Member entry
+      template <typename T, typename TMember>
+      constexpr inline Member<T, TMember> MakeMember(std::string_view key, TMember T::* pointer) {
+        return Member<T, TMember>{key, pointer};
+      }
+
+      /**
+       * @brief Describe
+       *
+       * Key table of a structure. Specializations are created by
+       * \ref TS7_JSONRPC_DESCRIBE and provide a static constexpr function
+       * Members(), that returns a tuple of \ref Member entries.
+       *
+       * @tparam T The described structure.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct Describe;
+
+      /**
+       * @brief Described structure to json
+       *
+       * Converts a described structure to a json object by walking its
+       * compile time key table.
+       *
+       * @note The keys are member names and therefore never need escaping.
+       * They are stored as std::string_view literals, so no key string is
+       * built per conversion.
+       *
+       * @tparam T The described structure.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct DescribedAsJson {
+          static constexpr const JsonType type = JsonType::OBJECT;
+
+          static inline constexpr bool IsType(JsonType t) {
+            return type == t;
+          }
+
+          /**
+           * @brief constructor
+           *
+           * Stores the provided structure for later conversion.
+           *
+           * @param value The structure that shall be converted.
+           */
+          inline explicit DescribedAsJson(const T& value)
+            : value(value)
+          {}
+
+          /**
+           * @brief Json value cast
+           *
+           * Casts the instance to a json object with one entry per described member.
+           */
+          operator boost::json::value() const {
+            constexpr auto members = Describe<T>::Members();
+
+            boost::json::object o;
+            o.reserve(std::tuple_size<decltype(members)>::value);
+            std::apply([this, &o](const auto&... member) {
+              (o.emplace(
+                boost::json::string_view(member.key.data(), member.key.size()),
+                static_cast<boost::json::value>(AsJson<typename remove_cref<decltype(member)>::type>(value.*(member.pointer)))
+              ), ...);
+            }, members);
+
+            return o;
+          }
+
+          /// The stored value
+          T value;
+      };
+
+      /**
+       * @brief Described structure from json
+       *
+       * Converts a json object to a described structure. The object is
+       * walked once and every entry is matched against the compile time key
+       * table. Unknown keys are ignored.
+       *
+       * @note T needs to be default constructible.
+       *
+       * @tparam T The described structure.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct DescribedFromJson {
+          /// Conversion failure data type
+          using conversion_failure = error::maybe_failed<T, MemberFailure>;
+
+          /// default constructor
+          inline DescribedFromJson() = default;
+
+          /**
+           * @brief Conversion
+           *
+           * Converts the boost::json::value to the described structure.
+           *
+           * @param v The value that shall be converted.
+           *
+           * @return Returns the converted structure. If the value is not an
+           * object, its actual type is returned. If a member is missing or
+           * has the wrong type, its key and its actual and expected type are
+           * returned.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline conversion_failure operator()(const boost::json::value& v) const {
+            constexpr auto members = Describe<T>::Members();
+            constexpr std::size_t count = std::tuple_size<decltype(members)>::value;
+
+            if (!v.is_object()) {
+              return MemberFailure(GetJsonType(v));
+            }
+
+            T result;
+            std::bitset<count> found;
+            MemberFailure failure;
+
+            for (const auto& entry : v.as_object()) {
+              const std::string_view key(entry.key().data(), entry.key().size());
+              if (!assign(members, key, entry.value(), result, found, failure, std::make_index_sequence<count>{})) {
+                return failure;
+              }
+            }
+
+            if (!found.all()) {
+              return missing(members, found, std::make_index_sequence<count>{});
+            }
+
+            return conversion_failure(std::move(result));
+          }
+
+        protected:
+          /// Reports the first member, that was not found
+          template <typename TMembers, std::size_t... Is>
+          static inline MemberFailure missing(const TMembers& members, const std::bitset<sizeof...(Is)>& found, std::index_sequence<Is...>) {
+            MemberFailure failure;
+            (void)((!found.test(Is) ? (failure = MemberFailure(JsonType::NONE, AsJson<typename std::tuple_element<Is, TMembers>::type::type>::type, std::string(std::get<Is>(members).key), true), true) : false) || ...);
+            return failure;
+          }
+
+          template <typename TMembers, std::size_t... Is>
+          static inline bool assign(const TMembers& members, std::string_view key, const boost::json::value& v, T& result, std::bitset<sizeof...(Is)>& found, MemberFailure& failure, std::index_sequence<Is...>) {
+            bool succeeded = true;
+            // Only the first member with a matching key gets assigned
+            (void)((std::get<Is>(members).key == key ? (found.set(Is), succeeded = assignMember(std::get<Is>(members), v, result, failure), true) : false) || ...);
+            return succeeded;
+          }
+
+          template <typename TMember>
+          static inline bool assignMember(const TMember& member, const boost::json::value& v, T& result, MemberFailure& failure) {
+            FromJson<typename TMember::type> conv;
+            typename FromJson<typename TMember::type>::conversion_failure converted = conv(v);
+            if (!converted) {
+              failure = Failed(std::string(member.key), AsJson<typename TMember::type>::type, converted.getFailed());
+              return false;
+            }
+
+            result.*(member.pointer) = std::move(converted).getSuccess();
+            return true;
+          }
+
+          /// Failure of the scalar member \p key
+          static inline MemberFailure Failed(std::string key, JsonType expected, JsonType actual) {
+            return MemberFailure(actual, expected, std::move(key));
+          }
+
+          /// Failure of the array member \p key, names the failing element
+          static inline MemberFailure Failed(std::string key, JsonType expected, const ArrayElementFailure& failure) {
+            if (failure.isElement()) {
+              return MemberFailure(failure.actual, failure.expected, key + "[" + std::to_string(failure.index) + "]");
+            }
+
+            return MemberFailure(failure.actual, expected, std::move(key));
+          }
+
+          /// Failure of the nested structure \p key, names the failing member of it
+          static inline MemberFailure Failed(std::string key, JsonType expected, const MemberFailure& failure) {
+            if (failure.isMember()) {
+              return MemberFailure(failure.actual, failure.expected, key + "." + failure.member, failure.missing);
+            }
+
+            return MemberFailure(failure.actual, expected, std::move(key));
+          }
+      };
+    }
+  }
+}
+
+/// Creates one \ref ts7::jsonrpc::util::Member entry of the key table
+#define TS7_JSONRPC_DESCRIBE_MEMBER(s, Type, member) ::ts7::jsonrpc::util::MakeMember(BOOST_PP_STRINGIZE(member), &Type::member)
+
+/**
+ * @brief Describe a structure
+ *
+ * Creates the key table as well as the \ref ts7::jsonrpc::util::AsJson and
+ * \ref ts7::jsonrpc::util::FromJson specializations for a structure, so it can
+ * be used as parameter or result type without writing the conversion by hand.
+ *
+ * @code
+ * struct Point { std::int32_t x; std::int32_t y; };
+ * TS7_JSONRPC_DESCRIBE(Point, x, y)
+ * @endcode
+ *
+ * @note Needs to be used in the global namespace with the fully qualified
+ * type name.
+ *
+ * @since 1.0
+ *
+ * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+ */
+#define TS7_JSONRPC_DESCRIBE(Type, ...) \
+  namespace ts7 { \
+    namespace jsonrpc { \
+      namespace util { \
+        template <> \
+        struct Describe<Type> { \
+          static constexpr inline auto Members() { \
+            return std::make_tuple(BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_TRANSFORM(TS7_JSONRPC_DESCRIBE_MEMBER, Type, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)))); \
+          } \
+        }; \
+        template <> \
+        struct AsJson<Type> : public DescribedAsJson<Type> { \
+          using DescribedAsJson<Type>::DescribedAsJson; \
+        }; \
+        template <> \
+        struct FromJson<Type> : public DescribedFromJson<Type> {}; \
+      } \
+    } \
+  }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Scheduling class
+       *
+       * Class of a procedure, that tells the executor how urgent its calls
+       * are. Executors with lanes queue every class separately, so cheap
+       * calls do not wait behind expensive ones.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      enum class SchedulingClass {
+        LATENCY_CRITICAL,
+        NORMAL,
+        BULK
+      };
+
+      /// Amount of scheduling classes
+      static constexpr const std::size_t scheduling_class_count = 3;
+
+      /**
+       * @brief Executor
+       *
+       * Interface of the executors, that run the handling of received
+       * messages. The transports hand every message to an executor instead
+       * of creating a thread for it.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class Executor {
+        public:
+          using task_t = std::function<void()>;
+
+          virtual ~Executor() = default;
+
+          /**
+           * @brief Execute
+           *
+           * Runs \p task now or later, possibly on another thread.
+           *
+           * @param task The task that shall be executed.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          virtual void execute(task_t task) = 0;
+
+          /**
+           * @brief Execute
+           *
+           * Runs \p task as part of the scheduling class \p cls. Executors
+           * without lanes ignore the class.
+           *
+           * @param task The task that shall be executed.
+           * @param cls Scheduling class of the task.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          virtual void execute(task_t task, SchedulingClass cls) {
+            (void)cls;
+            execute(std::move(task));
+          }
+
+          /**
+           * @brief Shard
+           *
+           * Returns the executor of the tasks with the affinity \p key. A
+           * sharded executor runs all tasks of one key on the same thread in
+           * submission order, all others return themselves.
+           *
+           * @param key Affinity key, e.g. the id of a connection.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          virtual Executor* getShard(std::size_t key) {
+            (void)key;
+            return this;
+          }
+      };
+
+      /**
+       * @brief Inline executor
+       *
+       * Executor, that runs every task directly in the calling thread. This
+       * suits short tasks, e.g. releasing waiting calls on a client.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class InlineExecutor : public Executor {
+        public:
+          using Executor::execute;
+
+          inline void execute(task_t task) override {
+            task();
+          }
+      };
+    }
+  }
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include <boost/json.hpp>
 
 #include "always_false.hpp"
+#include "asjson.hpp"
 #include "jsontype.hpp"
 #include "../error/error.hpp"
 
@@ -457,11 +461,20 @@ namespace ts7 {
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
           inline conversion_failure operator()(const boost::json::value& v) const {
-            if ( !v.is_double() ) {
-              return GetJsonType(v);
+            // JSON does not distinguish integers and floats, accept integral literals like 1
+            if ( v.is_double() ) {
+              return conversion_failure(static_cast<float>(v.get_double()));
             }
 
-            return conversion_failure(v.as_double());
+            if ( v.is_int64() ) {
+              return conversion_failure(static_cast<float>(v.get_int64()));
+            }
+
+            if ( v.is_uint64() ) {
+              return conversion_failure(static_cast<float>(v.get_uint64()));
+            }
+
+            return GetJsonType(v);
           }
       };
 
@@ -497,11 +510,20 @@ namespace ts7 {
            * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
            */
           inline conversion_failure operator()(const boost::json::value& v) const {
-            if ( !v.is_double() ) {
-              return GetJsonType(v);
+            // JSON does not distinguish integers and floats, accept integral literals like 1
+            if ( v.is_double() ) {
+              return conversion_failure(static_cast<double>(v.get_double()));
+            }
+
+            if ( v.is_int64() ) {
+              return conversion_failure(static_cast<double>(v.get_int64()));
+            }
+
+            if ( v.is_uint64() ) {
+              return conversion_failure(static_cast<double>(v.get_uint64()));
             }
 
-            return conversion_failure(v.as_double());
+            return GetJsonType(v);
           }
       };
 
@@ -542,14 +564,238 @@ namespace ts7 {
               return GetJsonType(v);
             }
 
-            return conversion_failure(v.as_string().c_str());
+            const boost::json::string& s = v.as_string();
+            return conversion_failure(std::string(s.data(), s.size()));
           }
       };
 
       /**
-       * @brief bool from JSON
+       * @brief Json value to string view
        *
-       * Converts a boost::json::value to a bool.
+       * Converts a json value to a std::string_view, if the provided content
+       * of the boost::json::value is a string.
+       *
+       * @attention The view points into the storage of the provided value. It
+       * is only valid as long as the JSON document is alive and unchanged. For
+       * parameters this is the duration of the procedure call.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <>
+      struct FromJson<std::string_view> {
+          /// Conversion failure data type
+          using conversion_failure = error::maybe_failed<std::string_view, JsonType>;
+
+          /// default constructor
+          inline FromJson() = default;
+
+          /**
+           * @brief Conversion
+           *
+           * Creates a std::string_view on the string of the boost::json::value
+           * without copying it.
+           *
+           * @param v The value that shall be converted.
+           *
+           * @return Returns the view on the string. If the provided value is
+           * not a string, its actual type will be returned.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline conversion_failure operator()(const boost::json::value& v) const {
+            if (!v.is_string()) {
+              return GetJsonType(v);
+            }
+
+            const boost::json::string& s = v.as_string();
+            return conversion_failure(std::string_view(s.data(), s.size()));
+          }
+      };
+
+      /**
+       * @brief Array element failure
+       *
+       * Failure type of array conversions. Next to the actual data type it
+       * also stores the index of the element that could not be converted, so
+       * the error response can point to the offending element.
+       *
+       * @note If the value itself was not an array, \ref index is set to
+       * \ref npos and \ref expected is \p JsonType::ARRAY.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct ArrayElementFailure {
+          /// Index used, if the value was not an array at all
+          static constexpr const std::size_t npos = static_cast<std::size_t>(-1);
+
+          /// default constructor
+          constexpr inline ArrayElementFailure() = default;
+
+          /**
+           * @brief constructor
+           *
+           * @param actual The actual data type of the failing element.
+           * @param expected The expected data type of the element.
+           * @param index The index of the failing element.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          constexpr inline ArrayElementFailure(JsonType actual, JsonType expected = JsonType::ARRAY, std::size_t index = npos)
+            : actual(actual),
+              expected(expected),
+              index(index)
+          {}
+
+          /// Actual data type cast operator
+          constexpr inline operator JsonType() const {
+            return actual;
+          }
+
+          /// True, if the failure was caused by an element and not by the array itself
+          constexpr inline bool isElement() const {
+            return npos != index;
+          }
+
+          /// Actual data type of the failing element
+          JsonType actual = JsonType::NONE;
+          /// Expected data type of the failing element
+          JsonType expected = JsonType::ARRAY;
+          /// Index of the failing element
+          std::size_t index = npos;
+      };
+
+      /**
+       * @brief Member failure
+       *
+       * Failure type of described structure conversions. Next to the actual
+       * data type it also stores the key of the member that is missing or
+       * could not be converted, so the error response can name the offending
+       * field. Members of nested structures and arrays are named by their
+       * path, e.g. "position.x" or "points[2]".
+       *
+       * @note If the value itself was not an object, \ref member is empty and
+       * \ref expected is \p JsonType::OBJECT.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct MemberFailure {
+          /// default constructor
+          inline MemberFailure() = default;
+
+          /**
+           * @brief constructor
+           *
+           * @param actual The actual data type of the failing member.
+           * @param expected The expected data type of the member.
+           * @param member The key of the failing member.
+           * @param missing True, if the member is not present at all.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline MemberFailure(JsonType actual, JsonType expected = JsonType::OBJECT, std::string member = std::string(), bool missing = false)
+            : actual(actual),
+              expected(expected),
+              member(std::move(member)),
+              missing(missing)
+          {}
+
+          /// Actual data type cast operator
+          inline operator JsonType() const {
+            return actual;
+          }
+
+          /// True, if the failure was caused by a member and not by the object itself
+          inline bool isMember() const {
+            return !member.empty();
+          }
+
+          /// Actual data type of the failing member, \p JsonType::NONE if it is missing
+          JsonType actual = JsonType::NONE;
+          /// Expected data type of the failing member
+          JsonType expected = JsonType::OBJECT;
+          /// Key or path of the failing member
+          std::string member;
+          /// The member is not present
+          bool missing = false;
+      };
+
+      /**
+       * @brief Arithmetic array element
+       *
+       * Type check and unchecked extraction of arithmetic values. Used by the
+       * array conversion to validate all elements in one loop and afterwards
+       * copy them without any further checks or intermediate objects.
+       *
+       * @note The accepted JSON kinds are the same as the ones of the scalar
+       * \ref FromJson specializations.
+       *
+       * @tparam T Arithmetic data type.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      struct ArithmeticElement {
+          static_assert(std::is_arithmetic<T>::value, "ArithmeticElement requires an arithmetic type");
+
+          /// True, if the kind of \p v can be converted to T
+          static inline bool Accepts(const boost::json::value& v) {
+            if constexpr (std::is_same<T, bool>::value) {
+              return v.is_bool();
+            }
+            else if constexpr (std::is_floating_point<T>::value) {
+              return v.is_number();
+            }
+            else if constexpr (std::is_signed<T>::value) {
+              return v.is_int64();
+            }
+            else {
+              return v.is_int64() || v.is_uint64();
+            }
+          }
+
+          /// Extracts the value of \p v, which needs to be accepted by \ref Accepts
+          static inline T Extract(const boost::json::value& v) {
+            if constexpr (std::is_same<T, bool>::value) {
+              return v.get_bool();
+            }
+            else if constexpr (std::is_floating_point<T>::value) {
+              if (v.is_double()) {
+                return static_cast<T>(v.get_double());
+              }
+
+              return v.is_int64() ? static_cast<T>(v.get_int64()) : static_cast<T>(v.get_uint64());
+            }
+            else if constexpr (std::is_signed<T>::value) {
+              return static_cast<T>(v.get_int64());
+            }
+            else {
+              return v.is_int64() ? static_cast<T>(v.get_int64()) : static_cast<T>(v.get_uint64());
+            }
+          }
+      };
+
+      /**
+       * @brief std::vector from JSON
+       *
+       * Converts a boost::json::value to a std::vector.
+       *
+       * @note Arithmetic element types except bool use a fast path, that
+       * validates all elements first and afterwards copies them into the
+       * preallocated storage.
        *
        * @since 1.0
        *
@@ -558,7 +804,7 @@ namespace ts7 {
       template <typename T>
       struct FromJson<std::vector<T>> {
           /// Conversion failure data type
-          using conversion_failure = error::maybe_failed<std::vector<T>, JsonType>;
+          using conversion_failure = error::maybe_failed<std::vector<T>, ArrayElementFailure>;
 
           /// default constructor
           inline FromJson() = default;
@@ -566,12 +812,13 @@ namespace ts7 {
           /**
            * @brief Conversion
            *
-           * Converts the boost::json::value to a std::int32_t.
+           * Converts the boost::json::value to a std::vector.
            *
            * @param v The value that shall be converted.
            *
            * @return Returns the converted value, if successful. If the value
-           * has the wrong type, the actual type will be returned.
+           * or one of its elements has the wrong type, the actual type and the
+           * index of the failing element will be returned.
            *
            * @since 1.0
            *
@@ -579,26 +826,55 @@ namespace ts7 {
            */
           inline conversion_failure operator()(const boost::json::value& v) const {
             if (!v.is_array()) {
-              return GetJsonType(v);
+              return ArrayElementFailure(GetJsonType(v));
             }
 
             const boost::json::array& a = v.as_array();
+            // std::vector<bool> packs its bits and has no data(), it uses the generic conversion
+            if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) {
+              return convertArithmetic(a);
+            }
+            else {
+              return convert(a);
+            }
+          }
+
+        protected:
+          inline conversion_failure convertArithmetic(const boost::json::array& a) const {
+            const std::size_t size = a.size();
+            const boost::json::value* elements = a.data();
+
+            // Validate every element, before anything gets allocated
+            for (std::size_t i = 0; i < size; ++i) {
+              if (!ArithmeticElement<T>::Accepts(elements[i])) {
+                return ArrayElementFailure(GetJsonType(elements[i]), AsJson<T>::type, i);
+              }
+            }
+
+            std::vector<T> data(size);
+            T* out = data.data();
+            for (std::size_t i = 0; i < size; ++i) {
+              out[i] = ArithmeticElement<T>::Extract(elements[i]);
+            }
+
+            return conversion_failure(std::move(data));
+          }
 
+          inline conversion_failure convert(const boost::json::array& a) const {
             std::vector<T> data;
             data.reserve(a.size());
 
             FromJson<T> conv;
-            for(const boost::json::value& sv : a) {
-              typename FromJson<T>::conversion_failure cf = conv(sv);
+            for (std::size_t i = 0; i < a.size(); ++i) {
+              typename FromJson<T>::conversion_failure cf = conv(a[i]);
               if ( !cf ) {
-                /// @todo How to return that error?!?
-                return GetJsonType(sv);
+                return ArrayElementFailure(static_cast<JsonType>(cf.getFailed()), AsJson<T>::type, i);
               }
 
               data.push_back(cf.getSuccess());
             }
 
-            return conversion_failure(data);
+            return conversion_failure(std::move(data));
           }
       };
     }
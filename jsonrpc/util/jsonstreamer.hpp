@@ -137,6 +137,11 @@ namespace ts7 {
           }
 
           inline bool operator==(const std::string& value) {
+            // The message might be incomplete, do not read beyond the data
+            if (static_cast<std::size_t>(end() - actual) < value.length()) {
+              return false;
+            }
+
             std::string compare = std::string(actual, actual+value.length());
             return value == compare;
           }
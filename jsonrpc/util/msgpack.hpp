@@ -0,0 +1,523 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <boost/json.hpp>
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief MessagePack codec
+       *
+       * Binary encoding of the boost::json::value model. It is used as an
+       * alternative wire format for connections, that do not need human
+       * readable messages. Procedures and modules work on the same
+       * boost::json::value in both cases.
+       *
+       * @note Doubles are always encoded as float 64 to keep their precision.
+       * Binary strings are decoded as JSON strings. Extension types and map
+       * keys, that are no strings, are not supported.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct MsgPack {
+        /// Maximum nesting depth accepted by the decoder
+        static constexpr const std::size_t max_depth = 32;
+
+        /**
+         * @brief MessagePack detection
+         *
+         * JSON-RPC messages are always a map (single message) or an array
+         * (batch). In MessagePack both start with a byte, that can never be
+         * the first byte of a JSON text.
+         *
+         * @param first The first byte of a message.
+         *
+         * @return Returns true, if the byte starts a MessagePack map or array.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static inline bool IsMsgPack(char first) {
+          const std::uint8_t b = static_cast<std::uint8_t>(first);
+          return (b >= 0x80 && b <= 0x9f) || (b >= 0xdc && b <= 0xdf);
+        }
+
+        /**
+         * @brief Encode
+         *
+         * Appends the MessagePack encoding of \p v to \p out.
+         *
+         * @param v The value that shall be encoded.
+         * @param out The buffer the encoded bytes are appended to.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static inline void Encode(const boost::json::value& v, std::string& out) {
+          switch (v.kind()) {
+            case boost::json::kind::null:
+              out.push_back(static_cast<char>(0xc0));
+              break;
+            case boost::json::kind::bool_:
+              out.push_back(static_cast<char>(v.get_bool() ? 0xc3 : 0xc2));
+              break;
+            case boost::json::kind::int64:
+              EncodeInt(v.get_int64(), out);
+              break;
+            case boost::json::kind::uint64:
+              EncodeUInt(v.get_uint64(), out);
+              break;
+            case boost::json::kind::double_: {
+              std::uint64_t bits;
+              const double d = v.get_double();
+              std::memcpy(&bits, &d, sizeof(bits));
+              out.push_back(static_cast<char>(0xcb));
+              PutBigEndian(bits, 8, out);
+              break;
+            }
+            case boost::json::kind::string: {
+              const boost::json::string& s = v.get_string();
+              EncodeHeader(s.size(), 0xa0, 32, 0xd9, 0xda, 0xdb, out);
+              out.append(s.data(), s.size());
+              break;
+            }
+            case boost::json::kind::array: {
+              const boost::json::array& a = v.get_array();
+              EncodeHeader(a.size(), 0x90, 16, 0, 0xdc, 0xdd, out);
+              for (const boost::json::value& e : a) {
+                Encode(e, out);
+              }
+              break;
+            }
+            case boost::json::kind::object: {
+              const boost::json::object& o = v.get_object();
+              EncodeHeader(o.size(), 0x80, 16, 0, 0xde, 0xdf, out);
+              for (const auto& e : o) {
+                EncodeHeader(e.key().size(), 0xa0, 32, 0xd9, 0xda, 0xdb, out);
+                out.append(e.key().data(), e.key().size());
+                Encode(e.value(), out);
+              }
+              break;
+            }
+          }
+        }
+
+        /// Returns the MessagePack encoding of \p v
+        static inline std::string Encode(const boost::json::value& v) {
+          std::string out;
+          Encode(v, out);
+          return out;
+        }
+
+        /**
+         * @brief Decode
+         *
+         * Decodes the first value of the provided bytes.
+         *
+         * @param data Pointer to the encoded bytes.
+         * @param size Amount of available bytes.
+         * @param v Receives the decoded value.
+         *
+         * @return Returns the amount of consumed bytes. Returns 0, if the
+         * value is incomplete and more bytes are required.
+         *
+         * @throws std::runtime_error If the data is no valid MessagePack or
+         * uses unsupported types.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        static inline std::size_t Decode(const char* data, std::size_t size, boost::json::value& v) {
+          Reader r{reinterpret_cast<const std::uint8_t*>(data), reinterpret_cast<const std::uint8_t*>(data) + size};
+          if (!DecodeValue(r, v, 0)) {
+            return 0;
+          }
+
+          return static_cast<std::size_t>(r.p - reinterpret_cast<const std::uint8_t*>(data));
+        }
+
+      protected:
+        struct Reader {
+          const std::uint8_t* p;
+          const std::uint8_t* end;
+
+          inline bool has(std::size_t n) const {
+            return static_cast<std::size_t>(end - p) >= n;
+          }
+
+          inline std::uint64_t take(std::size_t n) {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+              value = (value << 8) | p[i];
+            }
+
+            p += n;
+            return value;
+          }
+        };
+
+        static inline void PutBigEndian(std::uint64_t value, std::size_t bytes, std::string& out) {
+          for (std::size_t i = bytes; i > 0; --i) {
+            out.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xff));
+          }
+        }
+
+        static inline void EncodeHeader(std::size_t size, std::uint8_t fix, std::size_t fixLimit, std::uint8_t tag8, std::uint8_t tag16, std::uint8_t tag32, std::string& out) {
+          if (size < fixLimit) {
+            out.push_back(static_cast<char>(fix | size));
+          }
+          else if (0 != tag8 && size <= 0xff) {
+            out.push_back(static_cast<char>(tag8));
+            PutBigEndian(size, 1, out);
+          }
+          else if (size <= 0xffff) {
+            out.push_back(static_cast<char>(tag16));
+            PutBigEndian(size, 2, out);
+          }
+          else {
+            out.push_back(static_cast<char>(tag32));
+            PutBigEndian(size, 4, out);
+          }
+        }
+
+        static inline void EncodeUInt(std::uint64_t value, std::string& out) {
+          if (value < 0x80) {
+            out.push_back(static_cast<char>(value));
+          }
+          else if (value <= 0xff) {
+            out.push_back(static_cast<char>(0xcc));
+            PutBigEndian(value, 1, out);
+          }
+          else if (value <= 0xffff) {
+            out.push_back(static_cast<char>(0xcd));
+            PutBigEndian(value, 2, out);
+          }
+          else if (value <= 0xffffffff) {
+            out.push_back(static_cast<char>(0xce));
+            PutBigEndian(value, 4, out);
+          }
+          else {
+            out.push_back(static_cast<char>(0xcf));
+            PutBigEndian(value, 8, out);
+          }
+        }
+
+        static inline void EncodeInt(std::int64_t value, std::string& out) {
+          if (value >= 0) {
+            EncodeUInt(static_cast<std::uint64_t>(value), out);
+          }
+          else if (value >= -32) {
+            out.push_back(static_cast<char>(value));
+          }
+          else if (value >= std::numeric_limits<std::int8_t>::min()) {
+            out.push_back(static_cast<char>(0xd0));
+            PutBigEndian(static_cast<std::uint64_t>(value), 1, out);
+          }
+          else if (value >= std::numeric_limits<std::int16_t>::min()) {
+            out.push_back(static_cast<char>(0xd1));
+            PutBigEndian(static_cast<std::uint64_t>(value), 2, out);
+          }
+          else if (value >= std::numeric_limits<std::int32_t>::min()) {
+            out.push_back(static_cast<char>(0xd2));
+            PutBigEndian(static_cast<std::uint64_t>(value), 4, out);
+          }
+          else {
+            out.push_back(static_cast<char>(0xd3));
+            PutBigEndian(static_cast<std::uint64_t>(value), 8, out);
+          }
+        }
+
+        /// Stores unsigned values like the JSON parser: int64 if they fit
+        static inline void StoreUInt(std::uint64_t value, boost::json::value& v) {
+          if (value <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+            v = static_cast<std::int64_t>(value);
+          }
+          else {
+            v = value;
+          }
+        }
+
+        static inline std::int64_t SignExtend(std::uint64_t value, std::size_t bytes) {
+          const std::size_t shift = 64 - bytes * 8;
+          return static_cast<std::int64_t>(value << shift) >> shift;
+        }
+
+        static inline bool DecodeString(Reader& r, std::size_t lengthBytes, std::size_t length, std::string& s) {
+          if (0 != lengthBytes) {
+            if (!r.has(lengthBytes)) {
+              return false;
+            }
+
+            length = static_cast<std::size_t>(r.take(lengthBytes));
+          }
+
+          if (!r.has(length)) {
+            return false;
+          }
+
+          s.assign(reinterpret_cast<const char*>(r.p), length);
+          r.p += length;
+          return true;
+        }
+
+        static inline bool DecodeKey(Reader& r, std::string& key) {
+          if (!r.has(1)) {
+            return false;
+          }
+
+          const std::uint8_t b = *r.p++;
+          if ((b & 0xe0) == 0xa0) {
+            return DecodeString(r, 0, b & 0x1f, key);
+          }
+
+          switch (b) {
+            case 0xc4: case 0xd9: return DecodeString(r, 1, 0, key);
+            case 0xc5: case 0xda: return DecodeString(r, 2, 0, key);
+            case 0xc6: case 0xdb: return DecodeString(r, 4, 0, key);
+          }
+
+          throw std::runtime_error("MessagePack map keys need to be strings");
+        }
+
+        static inline bool DecodeArray(Reader& r, std::size_t count, boost::json::value& v, std::size_t depth) {
+          boost::json::array& a = v.emplace_array();
+          // Every element needs at least one byte, do not trust larger counts
+          const std::size_t available = static_cast<std::size_t>(r.end - r.p);
+          a.reserve(count < available ? count : available);
+          for (std::size_t i = 0; i < count; ++i) {
+            boost::json::value e;
+            if (!DecodeValue(r, e, depth + 1)) {
+              return false;
+            }
+
+            a.push_back(std::move(e));
+          }
+
+          return true;
+        }
+
+        static inline bool DecodeMap(Reader& r, std::size_t count, boost::json::value& v, std::size_t depth) {
+          boost::json::object& o = v.emplace_object();
+          std::string key;
+          for (std::size_t i = 0; i < count; ++i) {
+            if (!DecodeKey(r, key)) {
+              return false;
+            }
+
+            boost::json::value e;
+            if (!DecodeValue(r, e, depth + 1)) {
+              return false;
+            }
+
+            o[key] = std::move(e);
+          }
+
+          return true;
+        }
+
+        static inline bool DecodeValue(Reader& r, boost::json::value& v, std::size_t depth) {
+          if (depth > max_depth) {
+            throw std::runtime_error("MessagePack nesting too deep");
+          }
+
+          if (!r.has(1)) {
+            return false;
+          }
+
+          const std::uint8_t b = *r.p++;
+          if (b < 0x80) {
+            v = static_cast<std::int64_t>(b);
+            return true;
+          }
+
+          if (b >= 0xe0) {
+            v = static_cast<std::int64_t>(static_cast<std::int8_t>(b));
+            return true;
+          }
+
+          if ((b & 0xf0) == 0x80) {
+            return DecodeMap(r, b & 0x0f, v, depth);
+          }
+
+          if ((b & 0xf0) == 0x90) {
+            return DecodeArray(r, b & 0x0f, v, depth);
+          }
+
+          if ((b & 0xe0) == 0xa0) {
+            std::string s;
+            if (!DecodeString(r, 0, b & 0x1f, s)) {
+              return false;
+            }
+
+            v = boost::json::string_view(s.data(), s.size());
+            return true;
+          }
+
+          switch (b) {
+            case 0xc0:
+              v = nullptr;
+              return true;
+            case 0xc2:
+              v = false;
+              return true;
+            case 0xc3:
+              v = true;
+              return true;
+            case 0xc4: case 0xc5: case 0xc6:
+            case 0xd9: case 0xda: case 0xdb: {
+              const std::size_t lengthBytes = (b == 0xc4 || b == 0xd9) ? 1 : ((b == 0xc5 || b == 0xda) ? 2 : 4);
+              std::string s;
+              if (!DecodeString(r, lengthBytes, 0, s)) {
+                return false;
+              }
+
+              v = boost::json::string_view(s.data(), s.size());
+              return true;
+            }
+            case 0xca: {
+              if (!r.has(4)) {
+                return false;
+              }
+
+              const std::uint32_t bits = static_cast<std::uint32_t>(r.take(4));
+              float f;
+              std::memcpy(&f, &bits, sizeof(f));
+              v = static_cast<double>(f);
+              return true;
+            }
+            case 0xcb: {
+              if (!r.has(8)) {
+                return false;
+              }
+
+              const std::uint64_t bits = r.take(8);
+              double d;
+              std::memcpy(&d, &bits, sizeof(d));
+              v = d;
+              return true;
+            }
+            case 0xcc: case 0xcd: case 0xce: case 0xcf: {
+              const std::size_t bytes = std::size_t(1) << (b - 0xcc);
+              if (!r.has(bytes)) {
+                return false;
+              }
+
+              StoreUInt(r.take(bytes), v);
+              return true;
+            }
+            case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+              const std::size_t bytes = std::size_t(1) << (b - 0xd0);
+              if (!r.has(bytes)) {
+                return false;
+              }
+
+              v = SignExtend(r.take(bytes), bytes);
+              return true;
+            }
+            case 0xdc: case 0xdd: {
+              const std::size_t bytes = (b == 0xdc) ? 2 : 4;
+              if (!r.has(bytes)) {
+                return false;
+              }
+
+              return DecodeArray(r, static_cast<std::size_t>(r.take(bytes)), v, depth);
+            }
+            case 0xde: case 0xdf: {
+              const std::size_t bytes = (b == 0xde) ? 2 : 4;
+              if (!r.has(bytes)) {
+                return false;
+              }
+
+              return DecodeMap(r, static_cast<std::size_t>(r.take(bytes)), v, depth);
+            }
+          }
+
+          throw std::runtime_error("Unsupported MessagePack type");
+        }
+      };
+
+      /**
+       * @brief MessagePack streamer
+       *
+       * Counterpart of \ref JsonStreamer for MessagePack connections. Received
+       * bytes are appended and complete messages are taken out one by one.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct MsgPackStreamer {
+        inline MsgPackStreamer& operator+=(const std::string& s) {
+          data += s;
+          return *this;
+        }
+
+        inline std::string& getData() {
+          return data;
+        }
+
+        inline const std::string& getData() const {
+          return data;
+        }
+
+        /**
+         * @brief Next chunk
+         *
+         * @return Returns the next complete message, which is either an object
+         * or an array. Returns null, if no complete message is available.
+         *
+         * @throws std::runtime_error If the received data is no valid
+         * MessagePack. The buffered data is dropped in this case.
+         *
+         * @since 1.0
+         *
+         * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+         */
+        inline boost::json::value getNextChunk() {
+          while (offset < data.size()) {
+            boost::json::value v;
+            std::size_t consumed = 0;
+
+            try {
+              consumed = MsgPack::Decode(data.data() + offset, data.size() - offset, v);
+            }
+            catch (...) {
+              data.clear();
+              offset = 0;
+              throw;
+            }
+
+            if (0 == consumed) {
+              break;
+            }
+
+            offset += consumed;
+            if (v.is_object() || v.is_array()) {
+              return v;
+            }
+          }
+
+          // Drop consumed bytes, keep an incomplete message
+          data.erase(0, offset);
+          offset = 0;
+          return boost::json::value();
+        }
+
+      protected:
+        std::string data;
+        std::size_t offset = 0;
+      };
+    }
+  }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include "executor.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Sharded executor
+       *
+       * Executor with one worker thread per shard. Every connection is
+       * hashed to one shard by \ref getShard, so all of its messages are
+       * handled one after the other in receive order on the same thread.
+       * Responses go out in request order and the state of a connection
+       * stays on one core, handlers need no locks for it.
+       *
+       * This is the alternative to the shared \ref ThreadPool, which
+       * balances the load better but handles the messages of a connection
+       * concurrently.
+       *
+       * @code
+       * util::ShardedExecutor shards;
+       * com::TcpServer<std::int32_t, Owner> server(&owner, ctx, 9200, &shards);
+       * @endcode
+       *
+       * @note Scheduling classes are ignored, they would break the order.
+       * Inline procedures are answered directly by the I/O thread and may
+       * overtake the responses of earlier requests. A long running request
+       * delays all connections of its shard.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class ShardedExecutor : public Executor {
+        public:
+          /**
+           * @brief Shard
+           *
+           * Single worker thread with its own FIFO queue.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          class Shard : public Executor {
+            public:
+              using Executor::execute;
+
+              inline Shard()
+                : worker([this]() { run(); })
+              {}
+
+              Shard(const Shard&) = delete;
+              Shard& operator=(const Shard&) = delete;
+
+              inline ~Shard() override {
+                {
+                  std::lock_guard<std::mutex> lock(m);
+                  stopped = true;
+                }
+
+                cv.notify_one();
+                worker.join();
+              }
+
+              void execute(task_t task) override {
+                bool wake;
+                {
+                  std::lock_guard<std::mutex> lock(m);
+                  wake = queue.empty() && sleeping;
+                  queue.push_back(std::move(task));
+                }
+
+                if (wake) {
+                  cv.notify_one();
+                }
+              }
+
+              /// Returns the amount of submitted tasks, that did not start yet
+              inline std::size_t getPending() {
+                std::lock_guard<std::mutex> lock(m);
+                return queue.size();
+              }
+
+            protected:
+              void run() {
+                std::deque<task_t> tasks;
+                for (;;) {
+                  {
+                    // Take all queued tasks at once, one lock per burst
+                    std::unique_lock<std::mutex> lock(m);
+                    sleeping = true;
+                    cv.wait(lock, [this]() { return stopped || !queue.empty(); });
+                    sleeping = false;
+
+                    if (queue.empty()) {
+                      return;
+                    }
+
+                    tasks.swap(queue);
+                  }
+
+                  for (task_t& task : tasks) {
+                    try {
+                      task();
+                    }
+                    catch (const std::exception& e) {
+                      BOOST_LOG_TRIVIAL(error) << "Task failed: " << e.what();
+                    }
+                    catch (...) {
+                      BOOST_LOG_TRIVIAL(error) << "Task failed with an unknown exception";
+                    }
+                  }
+
+                  tasks.clear();
+                }
+              }
+
+              /// Guards the queue
+              std::mutex m;
+
+              /// Wakes the worker
+              std::condition_variable cv;
+
+              /// Submitted tasks
+              std::deque<task_t> queue;
+
+              /// The worker waits for tasks
+              bool sleeping = false;
+
+              /// The shard is shutting down
+              bool stopped = false;
+
+              /// Worker thread, started last
+              std::thread worker;
+          };
+
+          /**
+           * @brief constructor
+           *
+           * Starts the worker threads.
+           *
+           * @param shards Amount of shards, zero uses one per core.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit ShardedExecutor(std::size_t shards = 0) {
+            if (0 == shards) {
+              shards = std::thread::hardware_concurrency();
+            }
+
+            if (0 == shards) {
+              shards = 1;
+            }
+
+            for (std::size_t i = 0; i < shards; ++i) {
+              this->shards.emplace_back(new Shard());
+            }
+          }
+
+          ShardedExecutor(const ShardedExecutor&) = delete;
+          ShardedExecutor& operator=(const ShardedExecutor&) = delete;
+
+          /// Tasks without affinity run on the first shard
+          void execute(task_t task) override {
+            shards.front()->execute(std::move(task));
+          }
+
+          void execute(task_t task, SchedulingClass) override {
+            execute(std::move(task));
+          }
+
+          inline Executor* getShard(std::size_t key) override {
+            return shards[key % shards.size()].get();
+          }
+
+          inline std::size_t size() const {
+            return shards.size();
+          }
+
+        protected:
+          /// Shards, each with its own worker
+          std::vector<std::unique_ptr<Shard>> shards;
+      };
+    }
+  }
+}
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include "executor.hpp"
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Bounded queue
+       *
+       * Lock free queue with a fixed capacity for any amount of producers
+       * and consumers. Every cell carries a sequence number, that tells
+       * producers and consumers whether the cell is free or filled, so they
+       * only contend on the head or tail index.
+       *
+       * @tparam T Data type of the elements.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      class BoundedQueue {
+        public:
+          /**
+           * @brief constructor
+           *
+           * @param capacity Capacity of the queue, rounded up to a power of two.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit BoundedQueue(std::size_t capacity)
+            : mask(RoundUp(capacity) - 1),
+              cells(new Cell[mask + 1])
+          {
+            for (std::size_t i = 0; i <= mask; ++i) {
+              cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+          }
+
+          BoundedQueue(const BoundedQueue&) = delete;
+          BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+          /// Appends \p value, returns false if the queue is full
+          bool push(T& value) {
+            std::size_t pos = tail.load(std::memory_order_relaxed);
+            for (;;) {
+              Cell& cell = cells[pos & mask];
+              const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+              const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+              if (0 == diff) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                  cell.value = std::move(value);
+                  cell.sequence.store(pos + 1, std::memory_order_release);
+                  return true;
+                }
+              }
+              else if (diff < 0) {
+                return false;
+              }
+              else {
+                pos = tail.load(std::memory_order_relaxed);
+              }
+            }
+          }
+
+          /// Removes the first element into \p value, returns false if the queue is empty
+          bool pop(T& value) {
+            std::size_t pos = head.load(std::memory_order_relaxed);
+            for (;;) {
+              Cell& cell = cells[pos & mask];
+              const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+              const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+              if (0 == diff) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                  value = std::move(cell.value);
+                  cell.value = T();
+                  cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                  return true;
+                }
+              }
+              else if (diff < 0) {
+                return false;
+              }
+              else {
+                pos = head.load(std::memory_order_relaxed);
+              }
+            }
+          }
+
+        protected:
+          struct Cell {
+              std::atomic<std::size_t> sequence;
+              T value;
+          };
+
+          static inline std::size_t RoundUp(std::size_t n) {
+            std::size_t size = 2;
+            while (size < n) {
+              size <<= 1;
+            }
+
+            return size;
+          }
+
+          /// Index mask
+          const std::size_t mask;
+
+          /// Cells of the queue
+          std::unique_ptr<Cell[]> cells;
+
+          /// Consumer index
+          alignas(64) std::atomic<std::size_t> head{0};
+
+          /// Producer index
+          alignas(64) std::atomic<std::size_t> tail{0};
+      };
+
+      /**
+       * @brief Queue delay
+       *
+       * Statistics of the time, that tasks of one scheduling class waited
+       * in the queue before a worker started them.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct QueueDelay {
+          /// Amount of started tasks
+          std::size_t count = 0;
+
+          /// Sum of the delays
+          std::chrono::nanoseconds total{0};
+
+          /// Longest delay
+          std::chrono::nanoseconds max{0};
+
+          inline std::chrono::nanoseconds average() const {
+            return (0 == count) ? std::chrono::nanoseconds(0) : total / static_cast<std::chrono::nanoseconds::rep>(count);
+          }
+      };
+
+      /**
+       * @brief Thread pool
+       *
+       * Executor with a fixed amount of worker threads. Every scheduling
+       * class has its own lane, which consists of one lock free queue per
+       * worker. Tasks are distributed round robin, tasks that are submitted
+       * by a worker stay in its own queue. An idle worker steals from the
+       * queues of the other workers before it goes to sleep, so a burst on
+       * one queue is spread over all workers.
+       *
+       * Latency critical tasks have strict priority, they are meant to be
+       * short. The normal and bulk lanes are served by weighted round robin:
+       * out of 5 tasks a worker prefers 4 normal and 1 bulk task. A worker,
+       * whose preferred lane is empty, takes from the other one, so no worker
+       * idles while tasks are queued and bulk tasks do not starve.
+       *
+       * The amount of threads is fixed, no matter how many tasks are
+       * submitted. Tasks, that do not fit into the queues, wait in an
+       * overflow queue of their lane.
+       *
+       * @note Exceptions thrown by tasks are logged and dropped. The
+       * destructor finishes all submitted tasks before it returns.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class ThreadPool : public Executor {
+        public:
+          /// Default capacity of the queue of a worker
+          static constexpr const std::size_t default_queue_capacity = 4096;
+
+          /**
+           * @brief constructor
+           *
+           * Starts the worker threads.
+           *
+           * @param threads Amount of workers, zero uses one per core.
+           * @param queue_capacity Capacity of the queue of every worker.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit ThreadPool(std::size_t threads = 0, std::size_t queue_capacity = default_queue_capacity) {
+            if (0 == threads) {
+              threads = std::thread::hardware_concurrency();
+            }
+
+            if (0 == threads) {
+              threads = 1;
+            }
+
+            for (Lane& lane : lanes) {
+              for (std::size_t i = 0; i < threads; ++i) {
+                lane.queues.emplace_back(new BoundedQueue<Item>(queue_capacity));
+              }
+            }
+
+            for (std::size_t i = 0; i < threads; ++i) {
+              workers.emplace_back([this, i]() { run(i); });
+            }
+          }
+
+          ThreadPool(const ThreadPool&) = delete;
+          ThreadPool& operator=(const ThreadPool&) = delete;
+
+          inline ~ThreadPool() override {
+            {
+              std::lock_guard<std::mutex> lock(m);
+              stopped = true;
+            }
+
+            cv.notify_all();
+            for (std::thread& worker : workers) {
+              worker.join();
+            }
+          }
+
+          void execute(task_t task) override {
+            execute(std::move(task), SchedulingClass::NORMAL);
+          }
+
+          void execute(task_t task, SchedulingClass cls) override {
+            Lane& lane = lanes[static_cast<std::size_t>(cls)];
+            const std::size_t index = (this == Current().pool)
+              ? Current().index
+              : next.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+            Item item{std::move(task), std::chrono::steady_clock::now()};
+
+            // Count first, so a worker never sees more tasks than counted
+            lane.pending.fetch_add(1, std::memory_order_seq_cst);
+            pending.fetch_add(1, std::memory_order_seq_cst);
+            if (!lane.queues[index]->push(item)) {
+              std::lock_guard<std::mutex> lock(m);
+              lane.overflow.push_back(std::move(item));
+            }
+
+            if (idle.load(std::memory_order_seq_cst) > 0) {
+              std::lock_guard<std::mutex> lock(m);
+              cv.notify_one();
+            }
+          }
+
+          inline std::size_t size() const {
+            return workers.size();
+          }
+
+          /// Returns the amount of submitted tasks, that did not start yet
+          inline std::size_t getPending() const {
+            return pending.load(std::memory_order_relaxed);
+          }
+
+          /// Returns the amount of submitted tasks of \p cls, that did not start yet
+          inline std::size_t getPending(SchedulingClass cls) const {
+            return lanes[static_cast<std::size_t>(cls)].pending.load(std::memory_order_relaxed);
+          }
+
+          /// Returns the queueing delay of the tasks of \p cls
+          QueueDelay getQueueDelay(SchedulingClass cls) const {
+            const Lane& lane = lanes[static_cast<std::size_t>(cls)];
+
+            QueueDelay delay;
+            delay.count = lane.started.load(std::memory_order_relaxed);
+            delay.total = std::chrono::nanoseconds(lane.totalDelay.load(std::memory_order_relaxed));
+            delay.max = std::chrono::nanoseconds(lane.maxDelay.load(std::memory_order_relaxed));
+            return delay;
+          }
+
+        protected:
+          /// Queued task
+          struct Item {
+              task_t task;
+              std::chrono::steady_clock::time_point queued;
+          };
+
+          /// Queues and statistics of one scheduling class
+          struct Lane {
+              /// Queue per worker
+              std::vector<std::unique_ptr<BoundedQueue<Item>>> queues;
+
+              /// Tasks, that did not fit into the queues
+              std::deque<Item> overflow;
+
+              /// Amount of submitted tasks, that did not start yet
+              std::atomic<std::size_t> pending{0};
+
+              /// Amount of started tasks
+              std::atomic<std::size_t> started{0};
+
+              /// Sum of the queueing delays in nanoseconds
+              std::atomic<std::int64_t> totalDelay{0};
+
+              /// Longest queueing delay in nanoseconds
+              std::atomic<std::int64_t> maxDelay{0};
+          };
+
+          /// Pool, queue and round robin position of the calling worker thread
+          struct Worker {
+              const ThreadPool* pool = nullptr;
+              std::size_t index = 0;
+              std::size_t turn = 0;
+          };
+
+          static inline Worker& Current() {
+            thread_local Worker worker;
+            return worker;
+          }
+
+
+          void run(std::size_t index) {
+            Current().pool = this;
+            Current().index = index;
+
+            Item item;
+            for (;;) {
+              if (take(index, item)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                try {
+                  item.task();
+                }
+                catch (const std::exception& e) {
+                  BOOST_LOG_TRIVIAL(error) << "Task failed: " << e.what();
+                }
+                catch (...) {
+                  BOOST_LOG_TRIVIAL(error) << "Task failed with an unknown exception";
+                }
+
+                item.task = task_t();
+                continue;
+              }
+
+              std::unique_lock<std::mutex> lock(m);
+              idle.fetch_add(1, std::memory_order_seq_cst);
+              cv.wait(lock, [this]() { return stopped || pending.load(std::memory_order_seq_cst) > 0; });
+              idle.fetch_sub(1, std::memory_order_relaxed);
+
+              if (stopped && 0 == pending.load(std::memory_order_seq_cst)) {
+                return;
+              }
+            }
+          }
+
+          /// Takes a latency critical task, otherwise a normal or bulk task by weighted round robin
+          bool take(std::size_t index, Item& item) {
+            if (take(lanes[static_cast<std::size_t>(SchedulingClass::LATENCY_CRITICAL)], index, item)) {
+              return true;
+            }
+
+            Lane& normal = lanes[static_cast<std::size_t>(SchedulingClass::NORMAL)];
+            Lane& bulk = lanes[static_cast<std::size_t>(SchedulingClass::BULK)];
+            if (4 == Current().turn++ % 5) {
+              return take(bulk, index, item) || take(normal, index, item);
+            }
+
+            return take(normal, index, item) || take(bulk, index, item);
+          }
+
+          /// Takes a task from the own queue, the other queues or the overflow of \p lane
+          bool take(Lane& lane, std::size_t index, Item& item) {
+            if (0 == lane.pending.load(std::memory_order_seq_cst)) {
+              return false;
+            }
+
+            bool taken = lane.queues[index]->pop(item);
+            for (std::size_t i = 1; !taken && i < lane.queues.size(); ++i) {
+              taken = lane.queues[(index + i) % lane.queues.size()]->pop(item);
+            }
+
+            if (!taken) {
+              std::lock_guard<std::mutex> lock(m);
+              if (lane.overflow.empty()) {
+                return false;
+              }
+
+              item = std::move(lane.overflow.front());
+              lane.overflow.pop_front();
+            }
+
+            lane.pending.fetch_sub(1, std::memory_order_relaxed);
+            record(lane, std::chrono::steady_clock::now() - item.queued);
+            return true;
+          }
+
+          /// Adds \p delay to the statistics of \p lane
+          static void record(Lane& lane, std::chrono::steady_clock::duration delay) {
+            const std::int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+
+            lane.started.fetch_add(1, std::memory_order_relaxed);
+            lane.totalDelay.fetch_add(ns, std::memory_order_relaxed);
+
+            std::int64_t max = lane.maxDelay.load(std::memory_order_relaxed);
+            while (ns > max && !lane.maxDelay.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+          }
+
+          /// Lane per scheduling class
+          Lane lanes[scheduling_class_count];
+
+          /// Worker threads
+          std::vector<std::thread> workers;
+
+          /// Next queue for tasks from outside of the pool
+          std::atomic<std::size_t> next{0};
+
+          /// Amount of submitted tasks, that did not start yet
+          std::atomic<std::size_t> pending{0};
+
+          /// Amount of sleeping workers
+          std::atomic<std::size_t> idle{0};
+
+          /// Guards the sleeping workers and the overflow queues
+          std::mutex m;
+
+          /// Wakes sleeping workers
+          std::condition_variable cv;
+
+          /// The pool is shutting down
+          bool stopped = false;
+      };
+    }
+  }
+}
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ts7 {
+  namespace jsonrpc {
+    namespace util {
+      /**
+       * @brief Timer wheel
+       *
+       * Hierarchical timer wheel with four levels of 256 slots each. Timers
+       * are intrusive nodes, so scheduling and cancelling are O(1) and do not
+       * allocate. Timers beyond the range of the wheel wait in an overflow
+       * list until the top level wraps.
+       *
+       * A timer is placed on the level of the highest tick digit (8 bit
+       * each), in which its expiry differs from the current tick. Whenever
+       * the lower digits of the current tick wrap, the matching slot of the
+       * next level is cascaded to the lower levels.
+       *
+       * @note All functions are thread safe. Expiry callbacks are executed
+       * by the thread calling \ref advance, outside of the internal lock.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class TimerWheel {
+        public:
+          using clock_t = std::chrono::steady_clock;
+          using callback_t = std::function<void()>;
+
+          /// Bits per level
+          static constexpr const std::size_t slot_bits = 8;
+
+          /// Slots per level
+          static constexpr const std::size_t slots = std::size_t(1) << slot_bits;
+
+          /// Amount of levels
+          static constexpr const std::size_t levels = 4;
+
+          /**
+           * @brief Timer node
+           *
+           * Intrusive list node of a timer. It needs to be embedded in the
+           * object, that owns the timer, and must not be destroyed while it
+           * is scheduled.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          struct Node {
+              inline Node() = default;
+              Node(const Node&) = delete;
+              Node& operator=(const Node&) = delete;
+
+              inline bool isScheduled() const {
+                return nullptr != prev;
+              }
+
+              Node* prev = nullptr;
+              Node* next = nullptr;
+              std::uint64_t expiry = 0;
+              callback_t expired;
+          };
+
+          /**
+           * @brief constructor
+           *
+           * @param resolution Duration of one tick.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          inline explicit TimerWheel(clock_t::duration resolution = std::chrono::milliseconds(1))
+            : resolution(resolution),
+              start(clock_t::now())
+          {
+            for (std::size_t l = 0; l < levels; ++l) {
+              for (std::size_t s = 0; s < slots; ++s) {
+                Reset(wheel[l][s]);
+              }
+            }
+
+            Reset(overflow);
+          }
+
+          TimerWheel(const TimerWheel&) = delete;
+          TimerWheel& operator=(const TimerWheel&) = delete;
+
+          /**
+           * @brief Schedule
+           *
+           * Schedules \p node to expire after \p timeout, counted from now.
+           * An already scheduled node is rescheduled.
+           *
+           * @param node The timer node.
+           * @param timeout Duration until expiry, rounded up to full ticks.
+           * @param expired Callback executed on expiry.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          void schedule(Node& node, clock_t::duration timeout, callback_t expired) {
+            // Counted from now, the wheel is not advanced while it is idle
+            const clock_t::duration elapsed = clock_t::now() - start;
+            const std::uint64_t now = static_cast<std::uint64_t>(elapsed / resolution);
+            const std::uint64_t expiry = static_cast<std::uint64_t>((elapsed + timeout + resolution - clock_t::duration(1)) / resolution);
+
+            std::lock_guard<std::mutex> lock(m);
+            if (node.isScheduled()) {
+              Unlink(node);
+              --count;
+            }
+
+            if (0 == count && now > current) {
+              current = now;
+            }
+
+            node.expired = std::move(expired);
+            node.expiry = (expiry > current) ? expiry : current + 1;
+            insert(node);
+            ++count;
+          }
+
+          /**
+           * @brief Cancel
+           *
+           * Removes \p node from the wheel without executing its callback.
+           *
+           * @param node The timer node.
+           *
+           * @return Returns false, if the node was not scheduled.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          bool cancel(Node& node) {
+            callback_t expired;
+            {
+              std::lock_guard<std::mutex> lock(m);
+              if (!node.isScheduled()) {
+                return false;
+              }
+
+              Unlink(node);
+              --count;
+              expired = std::move(node.expired);
+            }
+
+            // Destroy the callback outside of the lock
+            return true;
+          }
+
+          /**
+           * @brief Advance
+           *
+           * Advances the wheel to \p now and executes the callbacks of all
+           * expired timers.
+           *
+           * @param now The current time.
+           *
+           * @return Returns the amount of expired timers.
+           *
+           * @since 1.0
+           *
+           * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+           */
+          std::size_t advance(clock_t::time_point now = clock_t::now()) {
+            std::vector<callback_t> expired;
+            {
+              std::lock_guard<std::mutex> lock(m);
+              const std::uint64_t target = static_cast<std::uint64_t>((now - start) / resolution);
+
+              if (0 == count) {
+                // Nothing to cascade or expire
+                current = (target > current) ? target : current;
+              }
+
+              while (current < target && count > 0) {
+                ++current;
+                cascade();
+
+                Node& head = wheel[0][current & (slots - 1)];
+                while (head.next != &head) {
+                  Node& node = *head.next;
+                  Unlink(node);
+                  --count;
+                  expired.push_back(std::move(node.expired));
+                }
+              }
+
+              if (current < target) {
+                current = target;
+              }
+            }
+
+            for (callback_t& callback : expired) {
+              if (callback) {
+                callback();
+              }
+            }
+
+            return expired.size();
+          }
+
+          /// Returns the amount of scheduled timers
+          inline std::size_t size() const {
+            std::lock_guard<std::mutex> lock(m);
+            return count;
+          }
+
+          inline bool empty() const {
+            return 0 == size();
+          }
+
+          inline clock_t::duration getResolution() const {
+            return resolution;
+          }
+
+        protected:
+          static inline void Reset(Node& head) {
+            head.prev = &head;
+            head.next = &head;
+          }
+
+          static inline void Unlink(Node& node) {
+            node.prev->next = node.next;
+            node.next->prev = node.prev;
+            node.prev = nullptr;
+            node.next = nullptr;
+          }
+
+          static inline void Append(Node& head, Node& node) {
+            node.prev = head.prev;
+            node.next = &head;
+            head.prev->next = &node;
+            head.prev = &node;
+          }
+
+          /// Inserts the node on the level of the highest differing digit
+          void insert(Node& node) {
+            const std::uint64_t difference = node.expiry ^ current;
+
+            for (std::size_t l = 0; l < levels; ++l) {
+              if ((difference >> (slot_bits * (l + 1))) == 0) {
+                Append(wheel[l][(node.expiry >> (slot_bits * l)) & (slots - 1)], node);
+                return;
+              }
+            }
+
+            Append(overflow, node);
+          }
+
+          /// Moves the timers of the reached slots to the lower levels
+          void cascade() {
+            for (std::size_t l = 1; l <= levels; ++l) {
+              if ((current & ((std::uint64_t(1) << (slot_bits * l)) - 1)) != 0) {
+                return;
+              }
+
+              Node& head = (l < levels) ? wheel[l][(current >> (slot_bits * l)) & (slots - 1)] : overflow;
+              Node pending;
+              Reset(pending);
+
+              // Detach first, reinsertion may target the same list for the overflow
+              if (head.next != &head) {
+                pending.next = head.next;
+                pending.prev = head.prev;
+                pending.next->prev = &pending;
+                pending.prev->next = &pending;
+                Reset(head);
+              }
+
+              while (pending.next != &pending) {
+                Node& node = *pending.next;
+                Unlink(node);
+                insert(node);
+              }
+            }
+          }
+
+          /// Duration of one tick
+          const clock_t::duration resolution;
+
+          /// Time of tick 0
+          const clock_t::time_point start;
+
+          /// Guards the wheel
+          mutable std::mutex m;
+
+          /// Current tick
+          std::uint64_t current = 0;
+
+          /// Amount of scheduled timers
+          std::size_t count = 0;
+
+          /// Slot list heads
+          Node wheel[levels][slots];
+
+          /// Timers beyond the range of the wheel
+          Node overflow;
+      };
+
+      /**
+       * @brief Timer service
+       *
+       * \ref TimerWheel with an own thread, that advances it. The thread
+       * only ticks while timers are scheduled.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      class TimerService {
+        public:
+          using clock_t = TimerWheel::clock_t;
+          using Node = TimerWheel::Node;
+
+          inline explicit TimerService(clock_t::duration resolution = std::chrono::milliseconds(1))
+            : wheel(resolution)
+          {}
+
+          inline ~TimerService() {
+            {
+              std::lock_guard<std::mutex> lock(m);
+              stopped = true;
+            }
+
+            cv.notify_all();
+            if (worker.joinable()) {
+              worker.join();
+            }
+          }
+
+          /// Schedules \p node, see \ref TimerWheel::schedule
+          void schedule(Node& node, clock_t::duration timeout, TimerWheel::callback_t expired) {
+            wheel.schedule(node, timeout, std::move(expired));
+
+            {
+              std::lock_guard<std::mutex> lock(m);
+              if (!worker.joinable()) {
+                worker = std::thread([this]() { run(); });
+              }
+            }
+
+            cv.notify_one();
+          }
+
+          /// Cancels \p node, see \ref TimerWheel::cancel
+          inline bool cancel(Node& node) {
+            return wheel.cancel(node);
+          }
+
+          inline std::size_t size() const {
+            return wheel.size();
+          }
+
+        protected:
+          void run() {
+            std::unique_lock<std::mutex> lock(m);
+            while (!stopped) {
+              if (wheel.empty()) {
+                cv.wait(lock);
+                continue;
+              }
+
+              cv.wait_for(lock, wheel.getResolution());
+
+              lock.unlock();
+              wheel.advance();
+              lock.lock();
+            }
+          }
+
+          TimerWheel wheel;
+          std::mutex m;
+          std::condition_variable cv;
+          std::thread worker;
+          bool stopped = false;
+      };
+    }
+  }
+}
@@ -3,6 +3,7 @@
 #include <boost/json.hpp>
 
 #include "always_false.hpp"
+#include "arrayview.hpp"
 #include "asjson.hpp"
 #include "fromjson.hpp"
 #include "remove_cref.hpp"
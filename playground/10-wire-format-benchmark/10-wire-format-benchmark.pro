@@ -0,0 +1,11 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../../
+
+SOURCES += \
+        main.cpp
+
+LIBS += -static -lboost_json
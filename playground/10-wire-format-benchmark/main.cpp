@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include <boost/json.hpp>
+
+#include <jsonrpc/util/msgpack.hpp>
+
+namespace ts7 {
+  namespace jsonrpc_playground {
+    namespace wire_format {
+      /**
+       * @brief Measure
+       *
+       * Runs the provided function repeatedly and prints the average duration.
+       *
+       * @param name Name of the measurement.
+       * @param iterations Amount of repetitions.
+       * @param f The measured function.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      void Measure(const std::string& name, std::size_t iterations, const std::function<void()>& f) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+          f();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        std::cout << "  " << name << ": " << ns << " ns" << std::endl;
+      }
+
+      /**
+       * @brief Compare
+       *
+       * Compares message size, encoding and decoding time of JSON text and
+       * MessagePack for the provided message.
+       *
+       * @param name Name of the message.
+       * @param message The message that shall be compared.
+       * @param iterations Amount of repetitions per measurement.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      void Compare(const std::string& name, const boost::json::value& message, std::size_t iterations) {
+        const std::string text = boost::json::serialize(message);
+        const std::string packed = ts7::jsonrpc::util::MsgPack::Encode(message);
+
+        std::cout << name << std::endl;
+        std::cout << "  size json: " << text.size() << " bytes, msgpack: " << packed.size() << " bytes" << std::endl;
+
+        std::size_t sink = 0;
+        Measure("encode json", iterations, [&]() {
+          sink += boost::json::serialize(message).size();
+        });
+        Measure("encode msgpack", iterations, [&]() {
+          sink += ts7::jsonrpc::util::MsgPack::Encode(message).size();
+        });
+        Measure("decode json", iterations, [&]() {
+          sink += boost::json::parse(text).is_object();
+        });
+        Measure("decode msgpack", iterations, [&]() {
+          boost::json::value v;
+          sink += ts7::jsonrpc::util::MsgPack::Decode(packed.data(), packed.size(), v);
+        });
+
+        boost::json::value decoded;
+        ts7::jsonrpc::util::MsgPack::Decode(packed.data(), packed.size(), decoded);
+        std::cout << "  round trip equal: " << std::boolalpha << (decoded == message) << " (" << sink << ")" << std::endl;
+      }
+    }
+  }
+}
+
+int main() {
+  using namespace ts7::jsonrpc_playground::wire_format;
+
+  // Small request with a few scalar parameters
+  boost::json::value small = {
+    {"jsonrpc", "2.0"},
+    {"method", "add"},
+    {"params", {{"a", 17}, {"b", -4}}},
+    {"id", 42}
+  };
+  Compare("small request", small, 100000);
+
+  // Large numeric payload, where the text conversion of doubles dominates
+  boost::json::array data;
+  data.reserve(100000);
+  for (std::size_t i = 0; i < 100000; ++i) {
+    data.push_back(i * 0.25 + 1.0 / (i + 1));
+  }
+
+  boost::json::value large = {
+    {"jsonrpc", "2.0"},
+    {"method", "store"},
+    {"params", {{"data", data}}},
+    {"id", 43}
+  };
+  Compare("100k doubles request", large, 20);
+
+  return 0;
+}
@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../../
+
+SOURCES += \
+        main.cpp
+
+DEFINES += BOOST_LOG_DYN_LINK
+
+LIBS += -lboost_json -lboost_log -lboost_thread -lboost_system -pthread
@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/json.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <jsonrpc/procedure.hpp>
+#include <jsonrpc/com/tcpserver.hpp>
+#include <jsonrpc/util/jsonstreamer.hpp>
+#include <jsonrpc/util/thread_pool.hpp>
+
+namespace ts7 {
+  namespace jsonrpc_playground {
+    namespace batch {
+      /**
+       * @brief Owner
+       *
+       * Minimal owner of the benchmarked server.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct Owner {
+          template <typename TPtr>
+          inline void registerCall(TPtr) {}
+          inline void releaseCall() {}
+          inline void responseReceived(const boost::json::object&) {}
+          inline void errorReceived(const boost::json::object&) {}
+      };
+
+      /**
+       * @brief Create batch
+       *
+       * Creates a batch of \p size requests of the procedure "work".
+       *
+       * @param size Amount of requests in the batch.
+       * @param cost Amount of iterations of every request.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      std::string CreateBatch(std::size_t size, std::int32_t cost) {
+        boost::json::array batch;
+        batch.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+          boost::json::object params;
+          params["n"] = cost;
+
+          boost::json::object request;
+          request["jsonrpc"] = "2.0";
+          request["method"] = "work";
+          request["params"] = std::move(params);
+          request["id"] = static_cast<std::int64_t>(i);
+          batch.push_back(std::move(request));
+        }
+
+        return boost::json::serialize(batch);
+      }
+
+      /**
+       * @brief Measure
+       *
+       * Sends batches of 1 to 10k requests to a server, whose received
+       * messages are handled by \p workers threads, and prints the average
+       * round trip time per batch and per element.
+       *
+       * @param workers Amount of worker threads of the server.
+       * @param cost Amount of iterations of every request.
+       * @param port Port of the server.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      void Measure(std::size_t workers, std::int32_t cost, std::uint16_t port) {
+        boost::asio::io_context ctx;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard(ctx.get_executor());
+        ts7::jsonrpc::util::ThreadPool pool(workers);
+        Owner owner;
+
+        ts7::jsonrpc::com::TcpServer<std::int32_t, Owner> server(&owner, ctx, port, &pool);
+        ts7::jsonrpc::Procedure<std::int32_t, std::int32_t, std::int32_t> work([](std::int32_t n) {
+          // Some CPU work per request
+          volatile std::int32_t sum = 0;
+          for (std::int32_t i = 0; i < n; ++i) {
+            sum = sum + i % 7;
+          }
+          return sum;
+        }, "n");
+        server.registerRequest("work", work);
+        server.startAccept();
+        std::thread io([&ctx]() { ctx.run(); });
+
+        boost::asio::io_context client_ctx;
+        boost::asio::ip::tcp::socket sock(client_ctx);
+        sock.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port));
+        sock.set_option(boost::asio::ip::tcp::no_delay(true));
+
+        std::cout << "workers: " << pool.size() << ", iterations per request: " << cost << std::endl;
+        for (std::size_t size = 1; size <= 10000; size *= 10) {
+          const std::string batch = CreateBatch(size, cost);
+          const std::size_t rounds = std::max<std::size_t>(10, 20000 / size);
+
+          char buffer[64 * 1024];
+          std::size_t answered = 0;
+          const auto start = std::chrono::steady_clock::now();
+          for (std::size_t r = 0; r < rounds; ++r) {
+            boost::asio::write(sock, boost::asio::buffer(batch));
+
+            // The response is a single array
+            ts7::jsonrpc::util::JsonStreamer streamer;
+            boost::json::value response;
+            while (response.is_null()) {
+              const std::size_t n = sock.read_some(boost::asio::buffer(buffer));
+              streamer += std::string(buffer, n);
+              response = streamer.getNextChunk();
+            }
+
+            answered += response.as_array().size();
+          }
+          const auto end = std::chrono::steady_clock::now();
+
+          const double us = std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+          std::cout << "  batch " << size << ": " << us << " us, " << us / size << " us per element"
+                    << (answered == size * rounds ? "" : " (missing responses)") << std::endl;
+        }
+
+        sock.close();
+        guard.reset();
+        ctx.stop();
+        io.join();
+      }
+    }
+  }
+}
+
+int main() {
+  using namespace ts7::jsonrpc_playground::batch;
+
+  boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+  // Sequential handling compared to all cores
+  Measure(1, 20000, 9301);
+  Measure(0, 20000, 9302);
+
+  return 0;
+}
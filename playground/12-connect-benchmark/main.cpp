@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/json.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <jsonrpc/procedure.hpp>
+#include <jsonrpc/com/tcpserver.hpp>
+
+namespace ts7 {
+  namespace jsonrpc_playground {
+    namespace connect {
+      /**
+       * @brief Owner
+       *
+       * Minimal owner of the benchmarked server.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      struct Owner {
+          template <typename TPtr>
+          inline void registerCall(TPtr) {}
+          inline void releaseCall() {}
+          inline void responseReceived(const boost::json::object&) {}
+          inline void errorReceived(const boost::json::object&) {}
+      };
+
+      /**
+       * @brief Measure
+       *
+       * Lets \p clients threads connect to a server, send one request, wait
+       * for its response and disconnect again for \p duration, and prints
+       * the connects per second.
+       *
+       * @param name Name of the configuration.
+       * @param options Options of the server.
+       * @param clients Amount of client threads.
+       * @param port Port of the server.
+       * @param duration Duration of the measurement.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      void Measure(const std::string& name, const ts7::jsonrpc::com::ServerOptions& options, std::size_t clients, std::uint16_t port, std::chrono::milliseconds duration = std::chrono::milliseconds(2000)) {
+        boost::asio::io_context ctx;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard(ctx.get_executor());
+        Owner owner;
+
+        ts7::jsonrpc::com::TcpServer<std::int32_t, Owner> server(&owner, ctx, port, options);
+        ts7::jsonrpc::Procedure<std::int32_t, std::int32_t> ping([]() {
+          return 1;
+        });
+        server.registerRequest("ping", ping, ts7::jsonrpc::util::SchedulingClass::NORMAL, true);
+        server.startAccept();
+        std::thread io([&ctx]() { ctx.run(); });
+
+        boost::json::object request;
+        request["jsonrpc"] = "2.0";
+        request["method"] = "ping";
+        request["params"] = boost::json::object();
+        request["id"] = 1;
+        const std::string message = boost::json::serialize(request);
+
+        const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(options.ipv6 ? "::1" : "127.0.0.1"), port);
+        std::atomic<bool> running{true};
+        std::atomic<std::size_t> connects{0};
+        std::atomic<std::size_t> failures{0};
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < clients; ++i) {
+          threads.emplace_back([&]() {
+            boost::asio::io_context client_ctx;
+            char buffer[1024];
+            while (running.load(std::memory_order_relaxed)) {
+              boost::system::error_code error;
+              boost::asio::ip::tcp::socket sock(client_ctx);
+              sock.connect(endpoint, error);
+              if (!error) {
+                sock.set_option(boost::asio::ip::tcp::no_delay(true), error);
+                boost::asio::write(sock, boost::asio::buffer(message), error);
+              }
+
+              if (!error) {
+                sock.read_some(boost::asio::buffer(buffer), error);
+              }
+
+              if (error) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+              }
+              else {
+                connects.fetch_add(1, std::memory_order_relaxed);
+              }
+
+              sock.close(error);
+            }
+          });
+        }
+
+        std::this_thread::sleep_for(duration);
+        running.store(false, std::memory_order_relaxed);
+        for (std::thread& thread : threads) {
+          thread.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(duration).count();
+        std::cout << "  " << name << ": " << static_cast<std::size_t>(connects.load() / seconds) << " connects/s"
+                  << (failures.load() > 0 ? ", " + std::to_string(failures.load()) + " failed" : std::string()) << std::endl;
+
+        guard.reset();
+        ctx.stop();
+        io.join();
+      }
+    }
+  }
+}
+
+int main() {
+  using namespace ts7::jsonrpc_playground::connect;
+  using ts7::jsonrpc::com::ServerOptions;
+
+  boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+  const std::size_t clients = 8;
+  std::cout << "clients: " << clients << ", one request per connection" << std::endl;
+
+  ServerOptions single;
+  single.no_delay = false;
+  Measure("1 pending accept, Nagle", single, clients, 9311);
+
+  ServerOptions defaults;
+  Measure("1 pending accept, no delay", defaults, clients, 9312);
+
+  ServerOptions tuned;
+  tuned.pending_accepts = 8;
+  tuned.backlog = 1024;
+  tuned.receive_buffer = 64 * 1024;
+  tuned.send_buffer = 64 * 1024;
+  Measure("8 pending accepts, no delay, 64k buffers", tuned, clients, 9313);
+
+  ServerOptions dual = tuned;
+  dual.ipv6 = true;
+  Measure("8 pending accepts, dual stack IPv6", dual, clients, 9314);
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <jsonrpc/util/timerwheel.hpp>
+
+namespace ts7 {
+  namespace jsonrpc_playground {
+    namespace timer_wheel {
+      using clock_t = ts7::jsonrpc::util::TimerService::clock_t;
+
+      /**
+       * @brief Expire after
+       *
+       * Arms a timer of \p timeout on \p service and waits for its expiry.
+       *
+       * @return Returns the time until the timer expired.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      clock_t::duration ExpireAfter(ts7::jsonrpc::util::TimerService& service, clock_t::duration timeout) {
+        std::mutex m;
+        std::condition_variable cv;
+        bool expired = false;
+
+        ts7::jsonrpc::util::TimerService::Node node;
+        const clock_t::time_point armed = clock_t::now();
+        service.schedule(node, timeout, [&]() {
+          std::lock_guard<std::mutex> lock(m);
+          expired = true;
+          cv.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&]() { return expired; });
+        return clock_t::now() - armed;
+      }
+
+      /**
+       * @brief Check
+       *
+       * Prints the time until a timer of \p timeout expired and whether it
+       * expired too early.
+       *
+       * @return Returns false, if the timer expired too early.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      bool Check(const char* name, ts7::jsonrpc::util::TimerService& service, clock_t::duration timeout) {
+        const clock_t::duration elapsed = ExpireAfter(service, timeout);
+        const bool ok = elapsed >= timeout;
+
+        std::cout << name << ": expired after " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms of "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count() << " ms"
+                  << (ok ? "" : " (too early)") << std::endl;
+        return ok;
+      }
+    }
+  }
+}
+
+int main() {
+  using namespace ts7::jsonrpc_playground::timer_wheel;
+
+  ts7::jsonrpc::util::TimerService service;
+  bool ok = Check("first timer", service, std::chrono::milliseconds(100));
+
+  // The wheel is not advanced while it is idle
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  ok = Check("timer after an idle period", service, std::chrono::milliseconds(1000)) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include <jsonrpc/util/fromjson.hpp>
+
+namespace ts7 {
+  namespace jsonrpc_playground {
+    namespace array_parameters {
+      /**
+       * @brief Convert
+       *
+       * Converts the JSON array \p text to a std::vector of \p T and
+       * compares it with \p expected.
+       *
+       * @return Returns false, if the conversion failed or the result
+       * differs.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      bool Convert(const char* name, const std::string& text, const std::vector<T>& expected) {
+        typename ts7::jsonrpc::util::FromJson<std::vector<T>>::conversion_failure result = ts7::jsonrpc::util::FromJson<std::vector<T>>()(boost::json::parse(text));
+        const bool ok = result && (result.getSuccess() == expected);
+
+        std::cout << name << ": " << text << (ok ? " converted" : " failed") << std::endl;
+        return ok;
+      }
+
+      /**
+       * @brief Reject
+       *
+       * Converts the JSON array \p text to a std::vector of \p T, which
+       * needs to fail at the element \p index.
+       *
+       * @return Returns false, if the conversion succeeded or failed at
+       * another element.
+       *
+       * @since 1.0
+       *
+       * @author Tarek Schwarzinger <tarek.schwarzinger@googlemail.com>
+       */
+      template <typename T>
+      bool Reject(const char* name, const std::string& text, std::size_t index) {
+        typename ts7::jsonrpc::util::FromJson<std::vector<T>>::conversion_failure result = ts7::jsonrpc::util::FromJson<std::vector<T>>()(boost::json::parse(text));
+        const bool ok = !result && result.getFailed().isElement() && (result.getFailed().index == index);
+
+        std::cout << name << ": " << text << (ok ? " rejected at element " + std::to_string(index) : std::string(" not rejected as expected")) << std::endl;
+        return ok;
+      }
+    }
+  }
+}
+
+int main() {
+  using namespace ts7::jsonrpc_playground::array_parameters;
+
+  bool ok = Convert<bool>("bool", "[true, false, true]", {true, false, true});
+  ok = Convert<std::int32_t>("int32", "[1, -2, 3]", {1, -2, 3}) && ok;
+  ok = Convert<double>("double with integral literals", "[1, 2.5, -3]", {1.0, 2.5, -3.0}) && ok;
+  ok = Convert<std::string>("string", "[\"a\", \"b\"]", {"a", "b"}) && ok;
+
+  ok = Reject<bool>("bool", "[true, 1]", 1) && ok;
+  ok = Reject<double>("double", "[1.5, \"2\"]", 1) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -9,4 +9,9 @@ SUBDIRS += \
     006-logging \
     007-ini-files \
     08-variadic-members \
-    09-create-request
+    09-create-request \
+    10-wire-format-benchmark \
+    11-batch-benchmark \
+    12-connect-benchmark \
+    13-timer-wheel \
+    14-array-parameters